@@ -0,0 +1,700 @@
+﻿#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L  /* clock_gettime() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "leptjson.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+//性能测试程序  生成一份样例文档  分别测量 压缩(无空白) 和 带缩进 两种文本的解析速度
+//用法: leptjson_bench [记录条数]
+
+//简单的动态字符缓冲区  用于拼接带缩进的文本
+typedef struct {
+	char* s;
+	size_t size, top;
+}bench_buffer;
+
+static void bench_puts(bench_buffer* b, const char* s, size_t len) {
+	if (b->top + len + 1 > b->size) {
+		while (b->top + len + 1 > b->size)
+			b->size = b->size ? b->size * 2 : 4096;
+		b->s = (char*)realloc(b->s, b->size);
+	}
+	memcpy(b->s + b->top, s, len);
+	b->top += len;
+	b->s[b->top] = '\0';
+}
+
+static void bench_newline(bench_buffer* b, int depth) {
+	int i;
+	bench_puts(b, "\n", 1);
+	for (i = 0; i < depth; i++)
+		bench_puts(b, "    ", 4);
+}
+
+//把标量(或对象的键)交给 lept_stringify 生成  再拼接进缓冲区
+static void bench_puts_value(bench_buffer* b, const lept_value* v) {
+	size_t len;
+	char* s = lept_stringify(v, &len);
+	bench_puts(b, s, len);
+	free(s);
+}
+
+//生成带4空格缩进的文本  模拟常见的 pretty-print 输出
+static void bench_pretty(bench_buffer* b, lept_value* v, int depth) {
+	size_t i, n;
+	lept_value key;
+	switch (lept_get_type(v)) {
+	case LEPT_ARRAY:
+		bench_puts(b, "[", 1);
+		n = lept_get_array_size(v);
+		for (i = 0; i < n; i++) {
+			bench_newline(b, depth + 1);
+			bench_pretty(b, lept_get_array_element(v, i), depth + 1);
+			if (i + 1 < n)
+				bench_puts(b, ",", 1);
+		}
+		if (n > 0)
+			bench_newline(b, depth);
+		bench_puts(b, "]", 1);
+		break;
+	case LEPT_OBJECT:
+		bench_puts(b, "{", 1);
+		n = lept_get_object_size(v);
+		for (i = 0; i < n; i++) {
+			bench_newline(b, depth + 1);
+			lept_init(&key);
+			lept_set_string(&key, lept_get_object_key(v, i), lept_get_object_key_length(v, i));
+			bench_puts_value(b, &key);
+			lept_free(&key);
+			bench_puts(b, ": ", 2);
+			bench_pretty(b, lept_get_object_value(v, i), depth + 1);
+			if (i + 1 < n)
+				bench_puts(b, ",", 1);
+		}
+		if (n > 0)
+			bench_newline(b, depth);
+		bench_puts(b, "}", 1);
+		break;
+	default:
+		bench_puts_value(b, v);
+	}
+}
+
+//生成样例文档  count 条类似用户记录的对象组成的数组
+static void bench_make_document(lept_value* v, size_t count) {
+	static const char* tags[] = { "alpha", "beta", "gamma", "delta" };
+	char name[48];
+	size_t i, j;
+	lept_value *r, *a, *o;
+
+	lept_set_array(v, count);
+	for (i = 0; i < count; i++) {
+		r = lept_pushback_array_element(v);
+		lept_set_object(r, 8);
+		lept_set_number(lept_set_object_value(r, "id", 2), (double)i);
+		sprintf(name, "user_%lu", (unsigned long)i);
+		lept_set_string(lept_set_object_value(r, "name", 4), name, strlen(name));
+		sprintf(name, "user_%lu@example.com", (unsigned long)i);
+		lept_set_string(lept_set_object_value(r, "email", 5), name, strlen(name));
+		lept_set_number(lept_set_object_value(r, "score", 5), i * 0.37 + 0.5);
+		lept_set_boolean(lept_set_object_value(r, "active", 6), (int)(i & 1));
+		a = lept_set_object_value(r, "tags", 4);
+		lept_set_array(a, 4);
+		for (j = 0; j <= i % 4; j++)
+			lept_set_string(lept_pushback_array_element(a), tags[j], strlen(tags[j]));
+		o = lept_set_object_value(r, "address", 7);
+		lept_set_object(o, 3);
+		lept_set_string(lept_set_object_value(o, "city", 4), "Hangzhou", 8);
+		lept_set_string(lept_set_object_value(o, "zip", 3), "310000", 6);
+		a = lept_set_object_value(o, "geo", 3);
+		lept_set_array(a, 2);
+		lept_set_number(lept_pushback_array_element(a), 120.15 + i * 1e-4);
+		lept_set_number(lept_pushback_array_element(a), 30.28 - i * 1e-4);
+	}
+}
+
+//生成以长字符串为主的文档  模拟日志消息和base64数据块
+static void bench_make_strings(lept_value* v, size_t count) {
+	static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	char s[1024];
+	size_t i, j;
+
+	lept_set_array(v, count);
+	for (i = 0; i < count; i++) {
+		if (i % 2) {
+			for (j = 0; j < sizeof(s); j++)
+				s[j] = b64[(i * 7 + j * 13) % 64];
+			lept_set_string(lept_pushback_array_element(v), s, sizeof(s));
+		}
+		else {
+			sprintf(s, "2024-05-01T12:00:%02lu.123Z INFO [worker-%lu] request \"GET /api/v1/items?page=%lu\" "
+				"completed in %lu ms, upstream=10.0.0.%lu:8080, bytes_sent=%lu, user_agent=\"Mozilla/5.0 (X11; Linux x86_64)\"\n",
+				(unsigned long)(i % 60), (unsigned long)(i % 16), (unsigned long)i,
+				(unsigned long)(i % 997), (unsigned long)(i % 255), (unsigned long)(i * 31));
+			lept_set_string(lept_pushback_array_element(v), s, strlen(s));
+		}
+	}
+}
+
+//生成以非ASCII字符为主的字符串  中文  俄文  emoji 混合  检验UTF-8校验的速度
+static void bench_make_utf8(lept_value* v, size_t count) {
+	static const char* const words[] = {
+		"\xE6\x9D\xAD\xE5\xB7\x9E", "\xE8\xAE\xA2\xE5\x8D\x95\xE5\xB7\xB2\xE5\x8F\x91\xE8\xB4\xA7",
+		"\xD0\x9C\xD0\xBE\xD1\x81\xD0\xBA\xD0\xB2\xD0\xB0", "\xF0\x9F\x98\x80", "caf\xC3\xA9", "ok"
+	};
+	char s[512];
+	size_t i, j, len;
+
+	lept_set_array(v, count);
+	for (i = 0; i < count; i++) {
+		for (j = len = 0; len < 200; j++) {
+			const char* w = words[(i + j * 7) % (sizeof(words) / sizeof(words[0]))];
+			memcpy(s + len, w, strlen(w));
+			len += strlen(w);
+			s[len++] = ' ';
+		}
+		lept_set_string(lept_pushback_array_element(v), s, len);
+	}
+}
+
+//生成浮点数数组  模拟遥测数据
+static void bench_make_numbers(lept_value* v, size_t count) {
+	size_t i;
+	lept_set_array(v, count * 8);
+	for (i = 0; i < count * 8; i++)
+		lept_set_number(lept_pushback_array_element(v), (double)(i % 1000) * 0.125 - 60.0 + (double)i * 1e-6);
+}
+
+//反复解析直到累计至少0.5秒CPU时间  返回 MB/s
+static double bench_parse(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0;
+	lept_value v;
+	do {
+		lept_init(&v);
+		if (lept_parse(&v, json) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		lept_free(&v);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//两阶段解析  先找出所有结构字符再建立树
+static double bench_parse_two_stage(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0;
+	lept_value v;
+	do {
+		lept_init(&v);
+		if (lept_parse_two_stage(&v, json, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		lept_free(&v);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//解析到同一个扁平文档中  条目数组和字符串缓冲区在两次解析之间重复使用
+static double bench_parse_tape(const char* json, size_t length, lept_tape* t) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0;
+	do {
+		if (lept_tape_parse(t, json, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//遍历整个树  累加所有数字和字符串的长度
+static double bench_walk_value(const lept_value* v) {
+	size_t i, n;
+	double sum = 0.0;
+	switch (lept_get_type(v)) {
+	case LEPT_NUMBER: return lept_get_number(v);
+	case LEPT_STRING: return (double)lept_get_string_length(v);
+	case LEPT_ARRAY:
+		for (i = 0, n = lept_get_array_size(v); i < n; i++)
+			sum += bench_walk_value(lept_get_array_element((lept_value*)v, i));
+		return sum;
+	case LEPT_OBJECT:
+		for (i = 0, n = lept_get_object_size(v); i < n; i++)
+			sum += bench_walk_value(lept_get_object_value((lept_value*)v, i));
+		return sum;
+	default: return 0.0;
+	}
+}
+
+//和 bench_walk_value() 相同  用 lept_tape_next() 顺序访问元素
+static double bench_walk_tape(const lept_tape* t, size_t i) {
+	size_t k, n, e;
+	double sum = 0.0;
+	switch (lept_tape_get_type(t, i)) {
+	case LEPT_NUMBER: return lept_tape_get_number(t, i);
+	case LEPT_STRING: return (double)lept_tape_get_string_length(t, i);
+	case LEPT_ARRAY:
+		n = lept_tape_get_array_size(t, i);
+		for (k = 0, e = i + 2; k < n; k++, e = lept_tape_next(t, e))
+			sum += bench_walk_tape(t, e);
+		return sum;
+	case LEPT_OBJECT:
+		n = lept_tape_get_object_size(t, i);
+		for (k = 0, e = i + 4; k < n; k++, e = lept_tape_next(t, e) + 2)
+			sum += bench_walk_tape(t, e);
+		return sum;
+	default: return 0.0;
+	}
+}
+
+//反复遍历  按文本长度计算 MB/s
+static double bench_walk(const lept_value* v, const lept_tape* t, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0;
+	volatile double sum;
+	do {
+		sum = t ? bench_walk_tape(t, lept_tape_root(t)) : bench_walk_value(v);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	(void)sum;
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//对每条记录取出同一组路径  比较每次都解释指针文本和预先编译的 lept_path
+static const char* bench_paths[] = { "/id", "/name", "/active", "/tags/0", "/address/city", "/address/geo/1" };
+
+//逐段切分指针文本  用 lept_find_object_value()/lept_get_array_element() 查找  (不处理 ~ 转义)
+static lept_value* bench_pointer_get(lept_value* v, const char* pointer) {
+	const char* s;
+	size_t len, index;
+	while (v != NULL && *pointer == '/') {
+		pointer++;
+		len = strcspn(pointer, "/");
+		if (lept_get_type(v) == LEPT_OBJECT)
+			v = lept_find_object_value(v, pointer, len);
+		else if (lept_get_type(v) == LEPT_ARRAY) {
+			for (index = 0, s = pointer; s != pointer + len; s++)
+				index = index * 10 + (size_t)(*s - '0');
+			v = index < lept_get_array_size(v) ? lept_get_array_element(v, index) : NULL;
+		}
+		else
+			v = NULL;
+		pointer += len;
+	}
+	return v;
+}
+
+static double bench_query(lept_value* doc, int compiled) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, n = lept_get_array_size(doc), i, j, count = sizeof(bench_paths) / sizeof(bench_paths[0]);
+	lept_path* paths[sizeof(bench_paths) / sizeof(bench_paths[0])];
+	volatile size_t found = 0;
+	for (j = 0; j < count; j++)
+		paths[j] = lept_path_compile(bench_paths[j], strlen(bench_paths[j]));
+	do {
+		for (i = 0; i < n; i++)
+			for (j = 0; j < count; j++)
+				found += (compiled ? lept_path_get(paths[j], lept_get_array_element(doc, i)) : bench_pointer_get(lept_get_array_element(doc, i), bench_paths[j])) != NULL;
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	for (j = 0; j < count; j++)
+		lept_path_destroy(paths[j]);
+	return (double)n * count * rounds / ((double)elapsed / CLOCKS_PER_SEC) / 1e6;
+}
+
+//从有2000个成员的对象中读出3个  比较完整解析和按需解析
+static const char* bench_lazy_keys[] = { "k100", "k1000", "k1900" };
+
+static double bench_pick_full(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, i;
+	volatile double sum = 0.0;
+	lept_value v;
+	do {
+		lept_init(&v);
+		if (lept_parse_n(&v, json, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		for (i = 0; i < 3; i++)
+			sum += bench_walk_value(lept_find_object_value(&v, bench_lazy_keys[i], strlen(bench_lazy_keys[i])));
+		lept_free(&v);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+static double bench_pick_lazy(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, i;
+	volatile double sum = 0.0;
+	lept_lazy* d = lept_lazy_create();
+	do {
+		if (lept_parse_lazy(d, json, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		for (i = 0; i < 3; i++)
+			sum += bench_walk_value(lept_lazy_get_value(lept_lazy_find_object_value(lept_lazy_root(d), bench_lazy_keys[i], strlen(bench_lazy_keys[i]))));
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	lept_lazy_destroy(d);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+static void bench_report_lazy(lept_value* doc) {
+	size_t i, n = lept_get_array_size(doc) < 2000 ? lept_get_array_size(doc) : 2000;
+	char key[32];
+	bench_buffer b = { NULL, 0, 0 };
+	//直接拼接文本  不经过 lept_set_object_value() 构造整个对象
+	bench_puts(&b, "{", 1);
+	for (i = 0; i < n; i++) {
+		sprintf(key, "%s\"k%lu\":", i > 0 ? "," : "", (unsigned long)i);
+		bench_puts(&b, key, strlen(key));
+		bench_puts_value(&b, lept_get_array_element(doc, i));
+	}
+	bench_puts(&b, "}", 1);
+	printf("pick 3 of %lu\n", (unsigned long)n);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "full", b.top / (1024.0 * 1024.0), bench_pick_full(b.s, b.top));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "lazy", b.top / (1024.0 * 1024.0), bench_pick_lazy(b.s, b.top));
+	free(b.s);
+}
+
+//解析到同一个 lept_document 中  arena 在两次解析之间重复使用
+static double bench_parse_document(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0;
+	lept_document* doc = lept_document_create();
+	do {
+		if (lept_document_parse_n(doc, json, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	lept_document_destroy(doc);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//原地解析  每次先把文本复制到可以修改的缓冲区(相当于接收缓冲区)  复制的时间也计算在内
+static double bench_parse_insitu(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0;
+	char* buf = (char*)malloc(length);
+	lept_value v;
+	do {
+		memcpy(buf, json, length);
+		lept_init(&v);
+		if (lept_parse_insitu(&v, buf, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		lept_free(&v);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	free(buf);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//push解析  文本按4KB一块传入  模拟从网络分块接收
+static double bench_parse_push(const char* json, size_t length) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, i;
+	lept_push_parser* p = lept_push_parser_create();
+	lept_value v;
+	do {
+		for (i = 0; i < length; i += 4096)
+			lept_push_parser_feed(p, json + i, length - i < 4096 ? length - i : 4096);
+		lept_init(&v);
+		if (lept_push_parser_finish(p, &v) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		lept_free(&v);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	lept_push_parser_destroy(p);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//SAX解析  只统计键的个数  不建立结点
+static int bench_on_key(void* user, const char* s, size_t len) {
+	++*(size_t*)user;
+	return 1;
+}
+
+static double bench_parse_sax(const char* json, size_t length) {
+	static const lept_handler handler = { NULL, NULL, NULL, NULL, NULL, bench_on_key, NULL, NULL, NULL };
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, keys = 0;
+	do {
+		if (lept_parse_sax(&handler, &keys, json, length) != LEPT_PARSE_OK) {
+			fprintf(stderr, "parse failed\n");
+			exit(1);
+		}
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//大量小文本  每条记录单独解析  比较每次新建栈的 lept_parse_n() 和保留栈的 lept_parser(以及键去重)
+static double bench_parse_small(char** jsons, const size_t* lengths, size_t count, lept_parser* parser) {
+	clock_t start = clock(), elapsed;
+	size_t i, total = 0;
+	lept_value v;
+	do {
+		for (i = 0; i < count; i++) {
+			lept_init(&v);
+			if ((parser ? lept_parser_parse(parser, &v, jsons[i], lengths[i]) : lept_parse_n(&v, jsons[i], lengths[i])) != LEPT_PARSE_OK) {
+				fprintf(stderr, "parse failed\n");
+				exit(1);
+			}
+			lept_free(&v);
+			total += lengths[i];
+		}
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	return (double)total / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+//打开或者不打开UTF-8校验  用同一个解析器解析
+static double bench_parse_utf8(char* json, size_t length, int validate) {
+	lept_parser* parser = lept_parser_create();
+	double mbs;
+	lept_parser_set_validate_utf8(parser, validate);
+	mbs = bench_parse_small(&json, &length, 1, parser);
+	lept_parser_destroy(parser);
+	return mbs;
+}
+
+static void bench_report_small(lept_value* doc) {
+	size_t i, n = lept_get_array_size(doc), total = 0;
+	char** jsons = (char**)malloc(n * sizeof(char*));
+	size_t* lengths = (size_t*)malloc(n * sizeof(size_t));
+	lept_parser* parser = lept_parser_create();
+	for (i = 0; i < n; i++) {
+		jsons[i] = lept_stringify(lept_get_array_element(doc, i), &lengths[i]);
+		total += lengths[i];
+	}
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "small", total / (1024.0 * 1024.0), bench_parse_small(jsons, lengths, n, NULL));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "parser", total / (1024.0 * 1024.0), bench_parse_small(jsons, lengths, n, parser));
+	lept_parser_set_intern_keys(parser, 1);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "interned", total / (1024.0 * 1024.0), bench_parse_small(jsons, lengths, n, parser));
+	lept_parser_destroy(parser);
+	for (i = 0; i < n; i++)
+		free(jsons[i]);
+	free(jsons);
+	free(lengths);
+}
+
+//反复生成直到累计至少0.5秒CPU时间  返回 MB/s(按生成的文本长度计算)
+//mode 为0时用 lept_stringify()   为1时只计算长度   为2时写入同一块预先分配好的缓冲区
+static double bench_stringify(const lept_value* v, int mode) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, length = lept_stringify_length(v), cap = length;
+	char* buf = mode == 2 ? (char*)malloc(cap) : NULL;
+	do {
+		if (mode == 0)
+			free(lept_stringify(v, &length));
+		else if (mode == 1)
+			length = lept_stringify_length(v);
+		else if (lept_stringify_into(v, buf, cap, &length) != 0)
+			exit(1);
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	free(buf);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+static void bench_report_stringify(const char* name, const lept_value* v) {
+	double mb = lept_stringify_length(v) / (1024.0 * 1024.0);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", name, mb, bench_stringify(v, 0));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "(length)", mb, bench_stringify(v, 1));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "(into)", mb, bench_stringify(v, 2));
+}
+
+//反复编码或解码CBOR直到累计至少0.5秒CPU时间  返回 MB/s(按CBOR数据长度计算)
+static double bench_cbor(const lept_value* v, int decode) {
+	clock_t start = clock(), elapsed;
+	size_t rounds = 0, length;
+	char* data = lept_encode_cbor(v, &length);
+	lept_value v2;
+	do {
+		if (decode) {
+			if (lept_decode_cbor(&v2, data, length) != LEPT_PARSE_OK)
+				exit(1);
+			lept_free(&v2);
+		}
+		else
+			free(lept_encode_cbor(v, &length));
+		rounds++;
+	} while ((elapsed = clock() - start) < CLOCKS_PER_SEC / 2);
+	free(data);
+	return (double)length * rounds / (1024.0 * 1024.0) / ((double)elapsed / CLOCKS_PER_SEC);
+}
+
+static void bench_report_cbor(const char* name, const lept_value* v) {
+	size_t length;
+	free(lept_encode_cbor(v, &length));
+	printf("%-10s %8.2f MB\n", name, lept_stringify_length(v) / (1024.0 * 1024.0));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "(encode)", length / (1024.0 * 1024.0), bench_cbor(v, 0));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "(decode)", length / (1024.0 * 1024.0), bench_cbor(v, 1));
+}
+
+//多线程的测试要用实际经过的时间  clock() 是所有线程的CPU时间之和
+static double bench_wall_clock(void) {
+#ifdef _WIN32
+	LARGE_INTEGER now, freq;
+	QueryPerformanceCounter(&now);
+	QueryPerformanceFrequency(&freq);
+	return (double)now.QuadPart / freq.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+static int bench_on_line(void* user, size_t line, int ret, lept_value* v) {
+	if (ret != LEPT_PARSE_OK) {
+		fprintf(stderr, "parse failed at line %lu\n", (unsigned long)line);
+		exit(1);
+	}
+	return 1;
+}
+
+//每条记录一行的NDJSON  threads 为0时使用全部CPU核
+static double bench_parse_ndjson(const char* json, size_t length, int threads) {
+	double start = bench_wall_clock(), elapsed;
+	size_t rounds = 0;
+	do {
+		lept_ndjson_parse(json, length, threads, bench_on_line, NULL);
+		rounds++;
+	} while ((elapsed = bench_wall_clock() - start) < 0.5);
+	return (double)length * rounds / (1024.0 * 1024.0) / elapsed;
+}
+
+static void bench_report_ndjson(lept_value* doc) {
+	static const int threads[] = { 1, 2, 4, 8, 0 };
+	bench_buffer b = { NULL, 0, 0 };
+	char name[16];
+	size_t i;
+	for (i = 0; i < lept_get_array_size(doc); i++) {
+		bench_puts_value(&b, lept_get_array_element(doc, i));
+		bench_puts(&b, "\n", 1);
+	}
+	for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		if (threads[i])
+			sprintf(name, "ndjson/%d", threads[i]);
+		else
+			strcpy(name, "ndjson/all");
+		printf("%-10s %8.2f MB %10.1f MB/s\n", name, b.top / (1024.0 * 1024.0), bench_parse_ndjson(b.s, b.top, threads[i]));
+	}
+	free(b.s);
+}
+
+static void bench_report(const char* name, const char* json, size_t length) {
+	printf("%-10s %8.2f MB %10.1f MB/s\n", name, length / (1024.0 * 1024.0), bench_parse(json, length));
+}
+
+int main(int argc, char* argv[]) {
+	size_t count = argc > 1 ? (size_t)atol(argv[1]) : 20000;
+	size_t length;
+	char* minified;
+	bench_buffer indented = { NULL, 0, 0 };
+	lept_value doc;
+	lept_tape* tape;
+	lept_parser* parser;
+
+	lept_init(&doc);
+	bench_make_document(&doc, count);
+	minified = lept_stringify(&doc, &length);
+	bench_pretty(&indented, &doc, 0);
+
+	printf("parse (%lu records)\n", (unsigned long)count);
+	bench_report("minified", minified, length);
+	bench_report("indented", indented.s, indented.top);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "two-stage", length / (1024.0 * 1024.0), bench_parse_two_stage(minified, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "(indented)", indented.top / (1024.0 * 1024.0), bench_parse_two_stage(indented.s, indented.top));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "document", length / (1024.0 * 1024.0), bench_parse_document(minified, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "insitu", length / (1024.0 * 1024.0), bench_parse_insitu(minified, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "push", length / (1024.0 * 1024.0), bench_parse_push(minified, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "sax", length / (1024.0 * 1024.0), bench_parse_sax(minified, length));
+	parser = lept_parser_create();
+	lept_parser_set_intern_keys(parser, 1);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "interned", length / (1024.0 * 1024.0), bench_parse_small(&minified, &length, 1, parser));
+	lept_parser_destroy(parser);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "no-check", length / (1024.0 * 1024.0), bench_parse_utf8(minified, length, 0));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "utf-8", length / (1024.0 * 1024.0), bench_parse_utf8(minified, length, 1));
+	bench_report_small(&doc);
+	tape = lept_tape_create();
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "tape", length / (1024.0 * 1024.0), bench_parse_tape(minified, length, tape));
+	printf("walk\n");
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "value", length / (1024.0 * 1024.0), bench_walk(&doc, NULL, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "tape", length / (1024.0 * 1024.0), bench_walk(NULL, tape, length));
+	lept_tape_destroy(tape);
+	bench_report_lazy(&doc);
+	printf("query (%lu paths per record)\n", (unsigned long)(sizeof(bench_paths) / sizeof(bench_paths[0])));
+	printf("%-10s %10.1f M/s\n", "text", bench_query(&doc, 0));
+	printf("%-10s %10.1f M/s\n", "compiled", bench_query(&doc, 1));
+	bench_report_ndjson(&doc);
+	lept_free(&doc);
+	free(minified);
+	free(indented.s);
+
+	lept_init(&doc);
+	bench_make_strings(&doc, count);
+	minified = lept_stringify(&doc, &length);
+	lept_free(&doc);
+	bench_report("strings", minified, length);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "two-stage", length / (1024.0 * 1024.0), bench_parse_two_stage(minified, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "insitu", length / (1024.0 * 1024.0), bench_parse_insitu(minified, length));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "no-check", length / (1024.0 * 1024.0), bench_parse_utf8(minified, length, 0));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "utf-8", length / (1024.0 * 1024.0), bench_parse_utf8(minified, length, 1));
+	free(minified);
+
+	lept_init(&doc);
+	bench_make_utf8(&doc, count);
+	minified = lept_stringify(&doc, &length);
+	lept_free(&doc);
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "non-ascii", length / (1024.0 * 1024.0), bench_parse_utf8(minified, length, 0));
+	printf("%-10s %8.2f MB %10.1f MB/s\n", "utf-8", length / (1024.0 * 1024.0), bench_parse_utf8(minified, length, 1));
+	free(minified);
+
+	lept_init(&doc);
+	bench_make_numbers(&doc, count);
+	minified = lept_stringify(&doc, &length);
+	bench_report("numbers", minified, length);
+	free(minified);
+
+	printf("stringify\n");
+	bench_report_stringify("numbers", &doc);
+	lept_free(&doc);
+	lept_init(&doc);
+	bench_make_strings(&doc, count);
+	bench_report_stringify("strings", &doc);
+	lept_free(&doc);
+	lept_init(&doc);
+	bench_make_document(&doc, count);
+	bench_report_stringify("records", &doc);
+
+	printf("cbor\n");
+	bench_report_cbor("records", &doc);
+	lept_free(&doc);
+	lept_init(&doc);
+	bench_make_numbers(&doc, count);
+	bench_report_cbor("numbers", &doc);
+	lept_free(&doc);
+	return 0;
+}
@@ -0,0 +1,421 @@
+﻿#include "leptjson.h"
+#include <assert.h>  /* assert() */
+#include <math.h>    /* ldexp(), HUGE_VAL */
+#include <stdlib.h>  /* malloc(), realloc(), free() */
+#include <string.h>  /* memcpy() */
+
+//CBOR(RFC 8949)  和JSON文本表示同样的 lept_value 树   每个数据项以一个字节开始  高3位是类型  低5位是附加信息
+//附加信息小于24时就是值(或长度)本身   24 25 26 27 表示后面跟着1 2 4 8个字节的大端整数
+//  0 无符号整数  1 负整数(-1-n)  2 字节串  3 UTF-8字符串  4 数组(n个元素)  5 映射(n对键值)  6 标签  7 浮点数和简单值
+//编码:  数字按 lept_value 的存储方式  整数编码成类型0/1   double 在不损失精度时编码成半精度或单精度
+//       数组/对象总是写出长度   对象的键写成字符串
+//解码:  按长度前缀预先分配数组/对象   也接受不定长的数组/映射/字符串(以0xFF结束)  字节串当作字符串  标签被忽略
+//       undefined 当作null   映射的键必须是字符串
+
+#ifndef LEPT_CBOR_INIT_SIZE
+#define LEPT_CBOR_INIT_SIZE 256   //编码缓冲区的初始大小
+#endif
+
+#ifndef LEPT_CBOR_MAX_DEPTH
+#define LEPT_CBOR_MAX_DEPTH 1024  //解码时数组/映射的最大嵌套层数  超过时返回 LEPT_PARSE_INVALID_VALUE
+#endif
+
+#define LEPT_CBOR_UINT     0
+#define LEPT_CBOR_NEGINT   1
+#define LEPT_CBOR_BYTES    2
+#define LEPT_CBOR_TEXT     3
+#define LEPT_CBOR_ARRAY    4
+#define LEPT_CBOR_MAP      5
+#define LEPT_CBOR_TAG      6
+#define LEPT_CBOR_SIMPLE   7
+#define LEPT_CBOR_INDEFINITE 31   //不定长的附加信息
+#define LEPT_CBOR_BREAK    0xFF   //不定长数据项的结束
+#define LEPT_CBOR_INT64_MAX ((lept_uint64)-1 >> 1)
+
+typedef struct {
+	unsigned char* s;
+	size_t size, top;
+}lept_cbor_buffer;
+
+static unsigned char* lept_cbor_push(lept_cbor_buffer* b, size_t n) {
+	if (b->top + n > b->size) {
+		while (b->top + n > b->size)
+			b->size += b->size >> 1;
+		b->s = (unsigned char*)realloc(b->s, b->size);
+	}
+	b->top += n;
+	return b->s + b->top - n;
+}
+
+//写出类型和值  用能放下值的最短形式
+static void lept_cbor_put_head(lept_cbor_buffer* b, int major, lept_uint64 n) {
+	unsigned char* p;
+	int i, bytes;
+	if (n < 24) {
+		*lept_cbor_push(b, 1) = (unsigned char)((major << 5) | (int)n);
+		return;
+	}
+	bytes = n <= 0xFF ? 1 : n <= 0xFFFF ? 2 : n <= 0xFFFFFFFFu ? 4 : 8;
+	p = lept_cbor_push(b, 1 + bytes);
+	p[0] = (unsigned char)((major << 5) | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27));
+	for (i = bytes; i > 0; i--, n >>= 8)
+		p[i] = (unsigned char)n;
+}
+
+//double 能被半精度(1位符号 5位指数 10位尾数)精确表示时返回它的编码  否则返回-1
+static long lept_cbor_half(double d) {
+	float f = (float)d;
+	unsigned u, sign, mant;
+	int exp;
+	if ((double)f != d)
+		return -1;//NaN也在这里排除  保留原来的编码
+	memcpy(&u, &f, sizeof(u));
+	sign = (u >> 16) & 0x8000;
+	exp = (int)((u >> 23) & 0xFF) - 127;
+	mant = u & 0x7FFFFF;
+	if (exp == -127 && mant == 0)
+		return (long)sign;//0和-0
+	if (exp == 128)
+		return (long)(sign | 0x7C00);//无穷大
+	if (exp >= -14 && exp <= 15 && (mant & 0x1FFF) == 0)
+		return (long)(sign | ((unsigned)(exp + 15) << 10) | (mant >> 13));
+	//半精度的非规格化数  值为 mant * 2^-24
+	if (exp >= -24 && exp < -14 && (mant & ((1u << (-1 - exp)) - 1)) == 0)
+		return (long)(sign | ((mant | 0x800000) >> (-1 - exp)));
+	return -1;
+}
+
+static void lept_cbor_put_double(lept_cbor_buffer* b, double d) {
+	unsigned char* p;
+	lept_uint64 u;
+	unsigned u32;
+	long h = lept_cbor_half(d);
+	float f = (float)d;
+	int i;
+	if (h >= 0) {
+		p = lept_cbor_push(b, 3);
+		p[0] = 0xF9;
+		p[1] = (unsigned char)(h >> 8);
+		p[2] = (unsigned char)h;
+	}
+	else if ((double)f == d) {
+		memcpy(&u32, &f, sizeof(u32));
+		p = lept_cbor_push(b, 5);
+		p[0] = 0xFA;
+		for (i = 4; i > 0; i--, u32 >>= 8)
+			p[i] = (unsigned char)u32;
+	}
+	else {
+		memcpy(&u, &d, sizeof(u));
+		p = lept_cbor_push(b, 9);
+		p[0] = 0xFB;
+		for (i = 8; i > 0; i--, u >>= 8)
+			p[i] = (unsigned char)u;
+	}
+}
+
+static void lept_cbor_put_value(lept_cbor_buffer* b, const lept_value* v) {
+	size_t i, n;
+	lept_int64 i64;
+	switch (lept_get_type(v)) {
+	case LEPT_NULL:  *lept_cbor_push(b, 1) = 0xF6; break;
+	case LEPT_FALSE: *lept_cbor_push(b, 1) = 0xF4; break;
+	case LEPT_TRUE:  *lept_cbor_push(b, 1) = 0xF5; break;
+	case LEPT_NUMBER:
+		switch (lept_get_number_type(v)) {
+		case LEPT_NUMBER_INT64:
+			i64 = lept_get_int64(v);
+			if (i64 >= 0)
+				lept_cbor_put_head(b, LEPT_CBOR_UINT, (lept_uint64)i64);
+			else
+				lept_cbor_put_head(b, LEPT_CBOR_NEGINT, (lept_uint64)(-1 - i64));
+			break;
+		case LEPT_NUMBER_UINT64:
+			lept_cbor_put_head(b, LEPT_CBOR_UINT, lept_get_uint64(v));
+			break;
+		default:
+			lept_cbor_put_double(b, lept_get_number(v));
+		}
+		break;
+	case LEPT_STRING:
+		n = lept_get_string_length(v);
+		lept_cbor_put_head(b, LEPT_CBOR_TEXT, n);
+		memcpy(lept_cbor_push(b, n), lept_get_string(v), n);
+		break;
+	case LEPT_ARRAY:
+		lept_cbor_put_head(b, LEPT_CBOR_ARRAY, lept_get_array_size(v));
+		for (i = 0; i < lept_get_array_size(v); i++)
+			lept_cbor_put_value(b, lept_get_array_element((lept_value*)v, i));
+		break;
+	case LEPT_OBJECT:
+		lept_cbor_put_head(b, LEPT_CBOR_MAP, lept_get_object_size(v));
+		for (i = 0; i < lept_get_object_size(v); i++) {
+			n = lept_get_object_key_length(v, i);
+			lept_cbor_put_head(b, LEPT_CBOR_TEXT, n);
+			memcpy(lept_cbor_push(b, n), lept_get_object_key(v, i), n);
+			lept_cbor_put_value(b, lept_get_object_value((lept_value*)v, i));
+		}
+		break;
+	default: assert(0 && "invalid type");
+	}
+}
+
+char* lept_encode_cbor(const lept_value* v, size_t* length) {
+	lept_cbor_buffer b;
+	assert(v != NULL);
+	b.s = (unsigned char*)malloc(b.size = LEPT_CBOR_INIT_SIZE);
+	b.top = 0;
+	lept_cbor_put_value(&b, v);
+	if (length)
+		*length = b.top;
+	return (char*)b.s;
+}
+
+typedef struct {
+	const unsigned char* p;
+	const unsigned char* end;
+	int depth;
+}lept_cbor_reader;
+
+//读出数据项的开始  *major 为类型  *info 为附加信息  *n 为值或者长度(不定长时为0)
+static int lept_cbor_get_head(lept_cbor_reader* r, int* major, int* info, lept_uint64* n) {
+	int i, bytes;
+	if (r->p == r->end)
+		return LEPT_PARSE_EXPECT_VALUE;
+	*major = *r->p >> 5;
+	*info = *r->p++ & 31;
+	*n = 0;
+	if (*info < 24) {
+		*n = (lept_uint64)*info;
+		return LEPT_PARSE_OK;
+	}
+	if (*info == LEPT_CBOR_INDEFINITE)
+		return *major >= LEPT_CBOR_BYTES && *major <= LEPT_CBOR_MAP ? LEPT_PARSE_OK : LEPT_PARSE_INVALID_VALUE;
+	if (*info > 27)
+		return LEPT_PARSE_INVALID_VALUE;//28~30 保留
+	bytes = 1 << (*info - 24);
+	if (r->end - r->p < bytes)
+		return LEPT_PARSE_EXPECT_VALUE;
+	for (i = 0; i < bytes; i++)
+		*n = (*n << 8) | *r->p++;
+	return LEPT_PARSE_OK;
+}
+
+//半精度转换成double   指数全1(无穷大和NaN)时返回 HUGE_VAL  由 lept_cbor_set_number() 拒绝
+static double lept_cbor_half_to_double(unsigned h) {
+	int exp = (int)((h >> 10) & 0x1F);
+	unsigned m = h & 0x3FF;
+	double d;
+	if (exp == 31)
+		return HUGE_VAL;
+	d = exp == 0 ? ldexp(m, -24) : ldexp(m | 0x400, exp - 25);
+	return h & 0x8000 ? -d : d;
+}
+
+//JSON 不能表示无穷大和NaN   和 lept_parse() 一样  太大的数返回 LEPT_PARSE_NUMBER_TOO_BIG
+static int lept_cbor_set_number(lept_value* v, double d) {
+	if (d == HUGE_VAL || d == -HUGE_VAL)
+		return LEPT_PARSE_NUMBER_TOO_BIG;
+	if (d != d)
+		return LEPT_PARSE_INVALID_VALUE;
+	lept_set_number(v, d);
+	return LEPT_PARSE_OK;
+}
+
+static int lept_cbor_get_value(lept_cbor_reader* r, lept_value* v);
+
+//字符串(字节串)  不定长时把各段连接起来   obj 不为NULL时作为 obj 的键加入  *member 为对应的值  否则写入v
+static int lept_cbor_get_string(lept_cbor_reader* r, int major, int info, lept_uint64 n, lept_value* v, lept_value* obj, lept_value** member) {
+	lept_cbor_buffer b;
+	int ret, m;
+	const char* s;
+	size_t len;
+	if (info != LEPT_CBOR_INDEFINITE) {
+		if ((lept_uint64)(r->end - r->p) < n)
+			return LEPT_PARSE_EXPECT_VALUE;
+		s = (const char*)r->p;
+		len = (size_t)n;
+		r->p += len;
+		if (obj)
+			return (*member = lept_append_object_value(obj, s, len)) != NULL ? LEPT_PARSE_OK : LEPT_PARSE_TOO_LARGE;
+		return lept_set_string(v, s, len) == 0 ? LEPT_PARSE_OK : LEPT_PARSE_TOO_LARGE;
+	}
+	//不定长  每一段都是同样类型的定长字符串
+	b.s = NULL;
+	b.size = b.top = 0;
+	for (;;) {
+		if (r->p == r->end) {
+			ret = LEPT_PARSE_EXPECT_VALUE;
+			break;
+		}
+		if (*r->p == LEPT_CBOR_BREAK) {
+			r->p++;
+			if (obj)
+				ret = (*member = lept_append_object_value(obj, b.top ? (const char*)b.s : "", b.top)) != NULL ? LEPT_PARSE_OK : LEPT_PARSE_TOO_LARGE;
+			else
+				ret = lept_set_string(v, b.top ? (const char*)b.s : "", b.top) == 0 ? LEPT_PARSE_OK : LEPT_PARSE_TOO_LARGE;
+			break;
+		}
+		if ((ret = lept_cbor_get_head(r, &m, &info, &n)) != LEPT_PARSE_OK)
+			break;
+		if (m != major || info == LEPT_CBOR_INDEFINITE) {
+			ret = LEPT_PARSE_INVALID_VALUE;
+			break;
+		}
+		if ((lept_uint64)(r->end - r->p) < n) {
+			ret = LEPT_PARSE_EXPECT_VALUE;
+			break;
+		}
+		len = (size_t)n;
+		if (len == 0)
+			continue;
+		if (b.top + len > b.size) {
+			b.size = b.top + len + (b.size >> 1) + 16;
+			b.s = (unsigned char*)realloc(b.s, b.size);
+		}
+		memcpy(b.s + b.top, r->p, len);
+		b.top += len;
+		r->p += len;
+	}
+	free(b.s);
+	return ret;
+}
+
+//是否是不定长数据项的结束
+#define LEPT_CBOR_AT_BREAK(r) ((r)->p != (r)->end && *(r)->p == LEPT_CBOR_BREAK)
+
+//元素个数超出 lept_value 能存放的范围时 lept_pushback_array_element() 返回NULL
+static int lept_cbor_get_element(lept_cbor_reader* r, lept_value* v) {
+	lept_value* e = lept_pushback_array_element(v);
+	return e != NULL ? lept_cbor_get_value(r, e) : LEPT_PARSE_TOO_LARGE;
+}
+
+static int lept_cbor_get_array(lept_cbor_reader* r, int info, lept_uint64 n, lept_value* v) {
+	int ret;
+	lept_uint64 i;
+	if (info == LEPT_CBOR_INDEFINITE) {
+		lept_set_array(v, 0);
+		while (!LEPT_CBOR_AT_BREAK(r))
+			if ((ret = lept_cbor_get_element(r, v)) != LEPT_PARSE_OK)
+				return ret;
+		r->p++;
+		return LEPT_PARSE_OK;
+	}
+	//每个元素至少1个字节  长度超过剩下的字节数时一定是不完整的  不按它分配内存
+	if (n > (lept_uint64)(r->end - r->p))
+		return LEPT_PARSE_EXPECT_VALUE;
+	lept_set_array(v, (size_t)n);
+	for (i = 0; i < n; i++)
+		if ((ret = lept_cbor_get_element(r, v)) != LEPT_PARSE_OK)
+			return ret;
+	return LEPT_PARSE_OK;
+}
+
+//键必须是字符串   重复的键和 lept_parse() 一样保留  这样 lept_encode_cbor() 生成的数据总能解码回来
+static int lept_cbor_get_member(lept_cbor_reader* r, lept_value* v) {
+	int ret, major, info;
+	lept_uint64 n;
+	lept_value* m = NULL;
+	if ((ret = lept_cbor_get_head(r, &major, &info, &n)) != LEPT_PARSE_OK)
+		return ret;
+	if (major != LEPT_CBOR_TEXT && major != LEPT_CBOR_BYTES)
+		return LEPT_PARSE_MISS_KEY;
+	if ((ret = lept_cbor_get_string(r, major, info, n, NULL, v, &m)) != LEPT_PARSE_OK)
+		return ret;
+	return lept_cbor_get_value(r, m);
+}
+
+static int lept_cbor_get_object(lept_cbor_reader* r, int info, lept_uint64 n, lept_value* v) {
+	int ret;
+	lept_uint64 i;
+	if (info == LEPT_CBOR_INDEFINITE) {
+		lept_set_object(v, 0);
+		while (!LEPT_CBOR_AT_BREAK(r))
+			if ((ret = lept_cbor_get_member(r, v)) != LEPT_PARSE_OK)
+				return ret;
+		r->p++;
+		return LEPT_PARSE_OK;
+	}
+	if (n > (lept_uint64)(r->end - r->p) / 2)
+		return LEPT_PARSE_EXPECT_VALUE;
+	lept_set_object(v, (size_t)n);
+	for (i = 0; i < n; i++)
+		if ((ret = lept_cbor_get_member(r, v)) != LEPT_PARSE_OK)
+			return ret;
+	return LEPT_PARSE_OK;
+}
+
+static int lept_cbor_get_value(lept_cbor_reader* r, lept_value* v) {
+	int ret, major, info;
+	lept_uint64 n;
+	float f;
+	double d;
+	unsigned u32;
+
+	//标签只是附加的说明  直接跳过
+	do {
+		if ((ret = lept_cbor_get_head(r, &major, &info, &n)) != LEPT_PARSE_OK)
+			return ret;
+	} while (major == LEPT_CBOR_TAG);
+
+	switch (major) {
+	case LEPT_CBOR_UINT:
+		if (n <= (lept_uint64)LEPT_CBOR_INT64_MAX)
+			lept_set_int64(v, (lept_int64)n);
+		else
+			lept_set_uint64(v, n);
+		return LEPT_PARSE_OK;
+	case LEPT_CBOR_NEGINT:
+		//-1-n 小于 int64 的最小值时只能用double表示
+		if (n <= (lept_uint64)LEPT_CBOR_INT64_MAX)
+			lept_set_int64(v, -1 - (lept_int64)n);
+		else
+			lept_set_number(v, -1.0 - (double)n);
+		return LEPT_PARSE_OK;
+	case LEPT_CBOR_BYTES:
+	case LEPT_CBOR_TEXT:
+		return lept_cbor_get_string(r, major, info, n, v, NULL, NULL);
+	case LEPT_CBOR_ARRAY:
+	case LEPT_CBOR_MAP:
+		if (r->depth == LEPT_CBOR_MAX_DEPTH)
+			return LEPT_PARSE_INVALID_VALUE;
+		r->depth++;
+		ret = major == LEPT_CBOR_ARRAY ? lept_cbor_get_array(r, info, n, v) : lept_cbor_get_object(r, info, n, v);
+		r->depth--;
+		return ret;
+	default:
+		switch (info) {
+		case 20: lept_set_boolean(v, 0); return LEPT_PARSE_OK;
+		case 21: lept_set_boolean(v, 1); return LEPT_PARSE_OK;
+		case 22:
+		case 23: lept_free(v); return LEPT_PARSE_OK;//null 和 undefined
+		case 25:
+			if ((n & 0x7C00) == 0x7C00 && (n & 0x3FF))
+				return LEPT_PARSE_INVALID_VALUE;//半精度的NaN
+			return lept_cbor_set_number(v, lept_cbor_half_to_double((unsigned)n));
+		case 26:
+			u32 = (unsigned)n;
+			memcpy(&f, &u32, sizeof(f));
+			return lept_cbor_set_number(v, f);
+		case 27:
+			memcpy(&d, &n, sizeof(d));
+			return lept_cbor_set_number(v, d);
+		default: return LEPT_PARSE_INVALID_VALUE;//其他简单值
+		}
+	}
+}
+
+int lept_decode_cbor(lept_value* v, const char* data, size_t len) {
+	lept_cbor_reader r;
+	int ret;
+	assert(v != NULL && (data != NULL || len == 0));
+	r.p = (const unsigned char*)data;
+	r.end = r.p + len;
+	r.depth = 0;
+	lept_init(v);
+	if ((ret = lept_cbor_get_value(&r, v)) == LEPT_PARSE_OK && r.p != r.end)
+		ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+	if (ret != LEPT_PARSE_OK)
+		lept_free(v);
+	return ret;
+}
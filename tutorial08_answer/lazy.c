@@ -0,0 +1,292 @@
+﻿#include "leptjson.h"
+#include "leptarena.h"
+#include <assert.h>  /* assert() */
+#include <stdlib.h>  /* malloc(), realloc(), free() */
+#include <string.h>  /* memcpy(), memcmp(), memchr() */
+
+//按需解析  lept_parse_lazy() 只检查语法(不建立任何结点)  记下根结点的位置
+//访问数组/对象时才逐个展开它的元素/成员  每个元素只记录在文本中的开始位置和类型  子树用括号和引号匹配直接跳过
+//查找和按下标访问只展开到找到为止  展开的结果缓存在结点中   标量和整个子树在 lept_lazy_get_value() 时才用 lept_parse_n() 解析
+//文本已经检查过  所以跳过和展开时不再检查错误
+
+#define LEPT_LAZY_ISWHITESPACE(ch) ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
+
+//展开的元素/成员   数组的元素 k 为NULL
+typedef struct {
+	const char* k;
+	size_t klen;
+	lept_lazy_value* v;
+}lept_lazy_member;
+
+struct lept_lazy_value {
+	lept_lazy* doc;
+	const char* json;        //值在文本中的开始
+	lept_type type;
+	lept_value* value;       //lept_lazy_get_value() 解析的结果
+	lept_lazy_member* m;     //已经展开的元素/成员
+	size_t size, capacity;
+	const char* next;        //下一个还没有展开的元素/成员  NULL 表示已经全部展开
+};
+
+struct lept_lazy {
+	const char *json, *end;
+	lept_lazy_value* root;
+	lept_arena arena;        //结点/键/成员数组从这里分配  只在销毁或重新解析时整体释放
+	lept_value** values;     //所有解析出的 lept_value  销毁时释放
+	size_t nvalues, values_capacity;
+};
+
+//重新解析时留下arena最新的一块  见 lept_arena_reset()
+static void lept_lazy_clear(lept_lazy* d) {
+	size_t i;
+	for (i = 0; i < d->nvalues; i++)
+		lept_free(d->values[i]);
+	d->nvalues = 0;
+	lept_arena_reset(&d->arena);
+	d->root = NULL;
+}
+
+static const char* lept_lazy_skip_whitespace(const char* p, const char* end) {
+	while (p != end && LEPT_LAZY_ISWHITESPACE(*p))
+		p++;
+	return p;
+}
+
+//p 指向开始的引号  返回结束的引号之后的位置   引号前面有偶数个连续的反斜杠时才是结束的引号
+static const char* lept_lazy_skip_string(const char* p, const char* end) {
+	const char* q;
+	for (p++;; p = q + 1) {
+		q = (const char*)memchr(p, '"', (size_t)(end - p));
+		assert(q != NULL);
+		for (p = q; p[-1] == '\\'; p--)
+			;
+		if ((q - p) % 2 == 0)
+			return q + 1;
+	}
+}
+
+//跳过一个完整的值  返回值之后的位置   数组/对象只匹配括号  括号出现在字符串中时不算
+static const char* lept_lazy_skip_value(const char* p, const char* end) {
+	size_t depth = 0;
+	do {
+		switch (*p) {
+		case '"': p = lept_lazy_skip_string(p, end); break;
+		case '[':
+		case '{': depth++; p++; break;
+		case ']':
+		case '}': depth--; p++; break;
+		default:
+			//字面值和数字一直到空白或者分隔符   在容器中时其他字符都可以逐个跳过
+			if (depth == 0) {
+				while (p != end && !LEPT_LAZY_ISWHITESPACE(*p) && *p != ',' && *p != ']' && *p != '}')
+					p++;
+				return p;
+			}
+			p++;
+			break;
+		}
+	} while (depth > 0);
+	return p;
+}
+
+static lept_lazy_value* lept_lazy_new_value(lept_lazy* d, const char* json) {
+	lept_lazy_value* v = (lept_lazy_value*)lept_arena_alloc(&d->arena, sizeof(lept_lazy_value));
+	v->doc = d;
+	v->json = json;
+	switch (*json) {
+	case 'n': v->type = LEPT_NULL; break;
+	case 't': v->type = LEPT_TRUE; break;
+	case 'f': v->type = LEPT_FALSE; break;
+	case '"': v->type = LEPT_STRING; break;
+	case '[': v->type = LEPT_ARRAY; break;
+	case '{': v->type = LEPT_OBJECT; break;
+	default:  v->type = LEPT_NUMBER; break;
+	}
+	v->value = NULL;
+	v->m = NULL;
+	v->size = v->capacity = 0;
+	v->next = v->type == LEPT_ARRAY || v->type == LEPT_OBJECT ? lept_lazy_skip_whitespace(json + 1, d->end) : NULL;
+	return v;
+}
+
+//解码 [p, end) 中的键  没有转义时直接复制
+static const char* lept_lazy_key(lept_lazy* d, const char* p, const char* end, size_t* klen) {
+	lept_value key;
+	char* k;
+	if (!memchr(p + 1, '\\', (size_t)(end - p - 2))) {
+		*klen = (size_t)(end - p - 2);
+		k = (char*)lept_arena_alloc(&d->arena, *klen + 1);
+		memcpy(k, p + 1, *klen);
+	}
+	else {
+		lept_init(&key);
+		lept_parse_n(&key, p, (size_t)(end - p));
+		*klen = lept_get_string_length(&key);
+		k = (char*)lept_arena_alloc(&d->arena, *klen + 1);
+		memcpy(k, lept_get_string(&key), *klen);
+		lept_free(&key);
+	}
+	k[*klen] = '\0';
+	return k;
+}
+
+//展开下一个元素/成员  返回它   已经全部展开时返回NULL
+static lept_lazy_member* lept_lazy_expand(lept_lazy_value* v) {
+	lept_lazy* d = v->doc;
+	const char *p = v->next, *q;
+	lept_lazy_member* m;
+	if (!p)
+		return NULL;
+	if (*p == ']' || *p == '}') {
+		v->next = NULL;
+		return NULL;
+	}
+	if (v->size == v->capacity) {
+		v->capacity = v->capacity ? v->capacity * 2 : 8;
+		m = (lept_lazy_member*)lept_arena_alloc(&d->arena, v->capacity * sizeof(lept_lazy_member));
+		if (v->size > 0)
+			memcpy(m, v->m, v->size * sizeof(lept_lazy_member));
+		v->m = m;
+	}
+	m = &v->m[v->size++];
+	m->k = NULL;
+	m->klen = 0;
+	if (v->type == LEPT_OBJECT) {
+		q = lept_lazy_skip_string(p, d->end);
+		m->k = lept_lazy_key(d, p, q, &m->klen);
+		p = lept_lazy_skip_whitespace(lept_lazy_skip_whitespace(q, d->end) + 1, d->end);
+	}
+	m->v = lept_lazy_new_value(d, p);
+	p = lept_lazy_skip_whitespace(lept_lazy_skip_value(p, d->end), d->end);
+	if (*p == ',')
+		p = lept_lazy_skip_whitespace(p + 1, d->end);
+	v->next = p;
+	return m;
+}
+
+//创建空的按需解析文档
+lept_lazy* lept_lazy_create(void) {
+	lept_lazy* d = (lept_lazy*)malloc(sizeof(lept_lazy));
+	d->json = d->end = NULL;
+	d->root = NULL;
+	d->arena.head = NULL;
+	d->arena.cur = d->arena.end = NULL;
+	d->values = NULL;
+	d->nvalues = d->values_capacity = 0;
+	return d;
+}
+
+void lept_lazy_destroy(lept_lazy* d) {
+	assert(d != NULL);
+	lept_lazy_clear(d);
+	lept_arena_free(&d->arena);
+	free(d->values);
+	free(d);
+}
+
+//API函数  检查语法并记录根结点   错误码和 lept_parse_n() 相同  失败时没有根结点
+//json 在文档销毁或者重新解析之前不能释放或修改
+int lept_parse_lazy(lept_lazy* d, const char* json, size_t len) {
+	static const lept_handler validate = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+	int ret;
+	assert(d != NULL && (json != NULL || len == 0));
+	lept_lazy_clear(d);
+	if ((ret = lept_parse_sax(&validate, NULL, json, len)) == LEPT_PARSE_OK) {
+		d->json = json;
+		d->end = json + len;
+		d->root = lept_lazy_new_value(d, lept_lazy_skip_whitespace(json, d->end));
+	}
+	return ret;
+}
+
+//根结点  解析失败或者还没有解析时为NULL
+lept_lazy_value* lept_lazy_root(lept_lazy* d) {
+	assert(d != NULL);
+	return d->root;
+}
+
+//类型由第一个字符决定  不需要解析
+lept_type lept_lazy_get_type(const lept_lazy_value* v) {
+	assert(v != NULL);
+	return v->type;
+}
+
+//解析整个值(数组/对象包括整个子树)  结果缓存在结点中  在文档销毁或者重新解析之前有效
+const lept_value* lept_lazy_get_value(lept_lazy_value* v) {
+	lept_lazy* d;
+	assert(v != NULL);
+	if (!v->value) {
+		d = v->doc;
+		v->value = (lept_value*)lept_arena_alloc(&d->arena, sizeof(lept_value));
+		lept_init(v->value);
+		lept_parse_n(v->value, v->json, (size_t)(lept_lazy_skip_value(v->json, d->end) - v->json));
+		if (d->nvalues == d->values_capacity) {
+			d->values_capacity = d->values_capacity ? d->values_capacity * 2 : 16;
+			d->values = (lept_value**)realloc(d->values, d->values_capacity * sizeof(lept_value*));
+		}
+		d->values[d->nvalues++] = v->value;
+	}
+	return v->value;
+}
+
+size_t lept_lazy_get_array_size(lept_lazy_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	while (lept_lazy_expand(v))
+		;
+	return v->size;
+}
+
+//只展开到第index个元素
+lept_lazy_value* lept_lazy_get_array_element(lept_lazy_value* v, size_t index) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	while (index >= v->size)
+		if (!lept_lazy_expand(v)) {
+			assert(!"index out of range");
+			return NULL;
+		}
+	return v->m[index].v;
+}
+
+size_t lept_lazy_get_object_size(lept_lazy_value* v) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	while (lept_lazy_expand(v))
+		;
+	return v->size;
+}
+
+static lept_lazy_member* lept_lazy_object_member(lept_lazy_value* v, size_t index) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	while (index >= v->size)
+		if (!lept_lazy_expand(v)) {
+			assert(!"index out of range");
+			return NULL;
+		}
+	return &v->m[index];
+}
+
+const char* lept_lazy_get_object_key(lept_lazy_value* v, size_t index) {
+	return lept_lazy_object_member(v, index)->k;
+}
+
+size_t lept_lazy_get_object_key_length(lept_lazy_value* v, size_t index) {
+	return lept_lazy_object_member(v, index)->klen;
+}
+
+lept_lazy_value* lept_lazy_get_object_value(lept_lazy_value* v, size_t index) {
+	return lept_lazy_object_member(v, index)->v;
+}
+
+//先在已经展开的成员中查找  找不到时继续展开  直到找到或者全部展开   不存在时返回NULL
+//有重复的键时返回第一个
+lept_lazy_value* lept_lazy_find_object_value(lept_lazy_value* v, const char* key, size_t klen) {
+	lept_lazy_member* m;
+	size_t i;
+	assert(v != NULL && v->type == LEPT_OBJECT && (key != NULL || klen == 0));
+	for (i = 0; i < v->size; i++)
+		if (v->m[i].klen == klen && memcmp(v->m[i].k, key, klen) == 0)
+			return v->m[i].v;
+	while ((m = lept_lazy_expand(v)) != NULL)
+		if (m->klen == klen && memcmp(m->k, key, klen) == 0)
+			return m->v;
+	return NULL;
+}
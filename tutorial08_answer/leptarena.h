@@ -0,0 +1,26 @@
+﻿#ifndef LEPTARENA_H__
+#define LEPTARENA_H__
+
+#include <stddef.h> /* size_t */
+
+//库内部使用  不属于公开的接口   leptjson.c 中实现  lept_document 和 lept_lazy 共用
+
+//arena 从大块内存中依次切出小块  不单独释放  只能整体释放
+//lept_document 用它存放解析出的字符串/数组/对象  销毁文档时只需释放这几个大块  不用逐个结点free
+typedef struct lept_arena_chunk lept_arena_chunk;
+struct lept_arena_chunk {
+	lept_arena_chunk* next; //上一块
+	size_t size;            //数据区的大小  数据区紧跟在这个结构之后
+};
+
+typedef struct {
+	lept_arena_chunk* head; //最新的一块
+	char *cur, *end;        //当前块中还没有分配的部分
+}lept_arena;
+
+//全部为0(NULL)时是空的arena
+void* lept_arena_alloc(lept_arena* a, size_t size);
+void lept_arena_reset(lept_arena* a);
+void lept_arena_free(lept_arena* a);
+
+#endif /* LEPTARENA_H__ */
@@ -3,12 +3,31 @@
 #include <crtdbg.h>
 #endif
 #include "leptjson.h"
+#include "leptarena.h"
 #include <assert.h>  /* assert() */
-#include <errno.h>   /* errno, ERANGE */
-#include <math.h>    /* HUGE_VAL */
-#include <stdio.h>   /* sprintf() */
-#include <stdlib.h>  /* NULL, malloc(), realloc(), free(), strtod() */
+#include <float.h>   /* FLT_EVAL_METHOD */
+#include <stdlib.h>  /* NULL, malloc(), realloc(), free() */
 #include <string.h>  /* memcpy() */
+#include <limits.h>  /* UINT_MAX */
+#include <time.h>    /* time() */
+#include <errno.h>   /* errno, EINTR */
+#ifdef _WIN32
+#include <io.h>      /* _write() */
+#include <windows.h>
+#include <bcrypt.h>  /* BCryptGenRandom() */
+#ifdef _MSC_VER
+#pragma comment(lib, "bcrypt.lib")
+#endif
+#define lept_write_fd(fd, buf, len) _write(fd, buf, (unsigned)(len))
+#else
+#include <unistd.h>  /* write(), read(), close() */
+#include <fcntl.h>   /* open() */
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+#define LEPT_HAVE_GETRANDOM
+#include <sys/random.h>  /* getrandom() */
+#endif
+#define lept_write_fd(fd, buf, len) write(fd, buf, len)
+#endif
 
 #ifndef LEPT_PARSE_STACK_INIT_SIZE  //使用 #ifndef X #define X ... #endif 方式的好处是，使用者可在编译选项中自行设置宏，没设置的话就用缺省值。
 #define LEPT_PARSE_STACK_INIT_SIZE 256 //栈初始大小
@@ -18,6 +37,76 @@
 #define LEPT_PARSE_STRINGIFY_INIT_SIZE 256  //生成器 临时缓冲区初始值大小
 #endif
 
+#ifndef LEPT_STRINGIFY_BUFFER_SIZE
+#define LEPT_STRINGIFY_BUFFER_SIZE 65536  //lept_stringify_to() 缓冲区的默认大小
+#endif
+
+#ifndef LEPT_STRINGIFY_STRING_CHUNK
+#define LEPT_STRINGIFY_STRING_CHUNK 512  //生成字符串时每次转义的字符数  每次最多向栈压入6倍的字节
+#endif
+
+#ifndef LEPT_TWO_STAGE_WINDOW
+#define LEPT_TWO_STAGE_WINDOW 4096  //两阶段解析每次第一阶段至少找出的结构字符个数  索引只占用固定大小的内存
+#endif
+
+#ifndef LEPT_PARSER_TRIM_SIZE
+#define LEPT_PARSER_TRIM_SIZE 65536  //lept_parser 每次解析后保留的栈的最大值  超过时缩小到这个大小
+#endif
+
+#ifndef LEPT_OBJECT_INDEX_THRESHOLD
+#define LEPT_OBJECT_INDEX_THRESHOLD 16  //对象的成员数超过这个值时建立哈希索引  之前线性查找更快
+#endif
+
+#ifndef LEPT_ARENA_CHUNK_SIZE
+#define LEPT_ARENA_CHUNK_SIZE 65536  //arena(lept_document  lept_lazy)第一块内存的大小  之后每块加倍
+#endif
+
+#ifndef LEPT_INTERN_MAX_KEYS
+#define LEPT_INTERN_MAX_KEYS 4096  //lept_parser 去重时最多记住的不同的键  之后出现的新键不再共用
+#endif
+
+//SIMD 加速  x86 上 SSE2 总是可用  AVX2 在运行时检测CPU后再启用
+//编译时定义 LEPT_NO_SIMD 可以关闭所有SIMD代码  只使用标量循环
+#ifndef LEPT_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEPT_SIMD_SSE2
+#include <emmintrin.h>  /* SSE2 */
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1800)
+#define LEPT_SIMD_AVX2
+#include <immintrin.h>  /* AVX2 */
+#endif
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>     /* __cpuid(), _BitScanForward(), _umul128() */
+#endif
+
+//GCC/Clang 需要用 target 属性单独为 AVX2 函数开启指令集   MSVC 不需要
+#if defined(__GNUC__) || defined(__clang__)
+#define LEPT_TARGET_AVX2    __attribute__((target("avx2")))
+#define LEPT_NO_SANITIZE    __attribute__((no_sanitize_address))
+#else
+#define LEPT_TARGET_AVX2
+#define LEPT_NO_SANITIZE
+#endif
+
+//共用的键的引用计数  共用同一个键的值可能在不同的线程中复制和释放  所以用原子操作
+//LEPT_ATOMIC_CAS() 在 *p 等于 o 时把它改成 n 并返回非0   用于只做一次的初始化  见 lept_hash_key()
+#if defined(_MSC_VER)
+#define LEPT_ATOMIC_INC(p)  _InterlockedIncrement(p)
+#define LEPT_ATOMIC_DEC(p)  _InterlockedDecrement(p)
+#define LEPT_ATOMIC_CAS(p, o, n)    (_InterlockedCompareExchange(p, n, o) == (o))
+#elif defined(__GNUC__) || defined(__clang__)
+#define LEPT_ATOMIC_INC(p)  __sync_add_and_fetch(p, 1)
+#define LEPT_ATOMIC_DEC(p)  __sync_sub_and_fetch(p, 1)
+#define LEPT_ATOMIC_CAS(p, o, n)    __sync_bool_compare_and_swap(p, o, n)
+#else
+#define LEPT_ATOMIC_INC(p)  (++*(p))
+#define LEPT_ATOMIC_DEC(p)  (--*(p))
+#define LEPT_ATOMIC_CAS(p, o, n)    (*(p) == (o) ? (*(p) = (n), 1) : 0)
+#endif
+
 //实现JSON主要完成三个需求
 //1.把 JSON 文本解析为一个树状数据结构（parse）
 //2.提供接口访问该数据结构（access）
@@ -27,8 +116,67 @@
 //先判断 预期值是否与实际值的第一个值相等  不等退  等 就将实际值的json指针前移一
 #define EXPECT(c, ch)       do { assert(*c->json == (ch)); c->json++; } while(0) 
 
+//lept_value::flags 中的标志位
+#define LEPT_FLAG_INT64     0x01 //数字按有符号64位整数存储
+#define LEPT_FLAG_UINT64    0x02 //数字按无符号64位整数存储(超出有符号范围的正整数)
+#define LEPT_FLAG_NUMBER    (LEPT_FLAG_INT64 | LEPT_FLAG_UINT64)
+#define LEPT_FLAG_ARENA     0x04 //字符串/数组/对象的内存块(对象还包括所有的键)在lept_document的arena中  不能free或realloc
+#define LEPT_FLAG_SEALED    0x08 //整个子树都在arena中  并且解析之后没有被修改过   释放时不需要遍历
+#define LEPT_FLAG_INDEXED   0x10 //对象的成员数组前面多分配了一个成员的位置  存放哈希索引的指针  见 lept_object_index
+#define LEPT_FLAG_BORROWED  0x20 //字符串/对象的所有键在 lept_parse_insitu() 的缓冲区中  不能free  (对象的成员数组仍然在堆上)
+#define LEPT_FLAG_INTERNED  0x40 //对象的所有键都带有引用计数  可能和其他对象共用  见 lept_key_header
+#define LEPT_FLAG_INLINE    0x80 //短字符串直接存放在结点中  没有单独分配内存
+
+//lept_value 的字段  两种布局见 leptjson.h
+//默认布局中对象有索引时  成员数组前面多分配一个成员的位置存放索引指针
+//紧凑布局中数组/对象的元素前面总是多分配一个位置(头部)  存放容量(和对象的索引指针)   没有分配时容量为0
+#ifndef LEPT_COMPACT_VALUE
+#define LEPT_A_SIZE(v)          ((v)->u.a.size)
+#define LEPT_O_SIZE(v)          ((v)->u.o.size)
+#define LEPT_S_LEN(v)           ((v)->u.s.len)
+#define LEPT_A_CAPACITY(v)      ((v)->u.a.capacity)
+#define LEPT_O_CAPACITY(v)      ((v)->u.o.capacity)
+#define LEPT_SET_A_CAPACITY(v, n)   ((v)->u.a.capacity = (n))
+#define LEPT_SET_O_CAPACITY(v, n)   ((v)->u.o.capacity = (n))
+#define LEPT_ARRAY_HEAD         0   //数组元素前面的头部占用的元素个数
+#define LEPT_OBJECT_HEAD        0   //新分配的成员数组前面的头部占用的成员个数(有索引时另外加上)
+#define LEPT_HAS_OBJECT_HEAD(v) ((v)->flags & LEPT_FLAG_INDEXED)
+#define LEPT_INLINE_S(v)        ((v)->u.is.s)
+#define LEPT_INLINE_LEN(v)      ((v)->u.is.len)
+#define LEPT_INLINE_STRING_MAX  (sizeof(((lept_value*)0)->u.is.s) - 1) //能直接存放在结点中的字符串的最大长度
+#define LEPT_SIZE_TOO_LARGE(n)  0   //字符串长度/元素个数是否超出结点能存放的范围
+#else
+#define LEPT_A_SIZE(v)          ((v)->size)
+#define LEPT_O_SIZE(v)          ((v)->size)
+#define LEPT_S_LEN(v)           ((v)->size)
+#define LEPT_A_CAPACITY(v)      ((v)->u.a.e != NULL ? (size_t)(v)->u.a.e[-1].u.u64 : 0)
+#define LEPT_O_CAPACITY(v)      ((v)->u.o.m != NULL ? (v)->u.o.m[-1].klen : 0)
+#define LEPT_SET_A_CAPACITY(v, n)   ((v)->u.a.e != NULL ? (void)((v)->u.a.e[-1].u.u64 = (n)) : (void)0)
+#define LEPT_SET_O_CAPACITY(v, n)   ((v)->u.o.m != NULL ? (void)((v)->u.o.m[-1].klen = (n)) : (void)0)
+#define LEPT_ARRAY_HEAD         1
+#define LEPT_OBJECT_HEAD        1
+#define LEPT_HAS_OBJECT_HEAD(v) ((v)->u.o.m != NULL)
+#define LEPT_INLINE_S(v)        ((char*)(v))    //从结点的第一个字节开始  到 tail 为止
+#define LEPT_INLINE_LEN(v)      ((v)->len)
+#define LEPT_INLINE_STRING_MAX  (offsetof(lept_value, len) - 1)
+#define LEPT_SIZE_TOO_LARGE(n)  ((n) > UINT_MAX)
+
+//紧凑布局必须正好是16字节  否则这里编译失败
+typedef char lept_compact_value_check[sizeof(lept_value) == 16 ? 1 : -1];
+#endif
+
+//返回可以修改的子结点之前调用  子结点可能被写入堆上分配的内容  释放时就需要遍历这个结点
+#define LEPT_UNSEAL(v)      ((v)->flags &= ~LEPT_FLAG_SEALED)
+
+#define LEPT_INT64_MAX      ((lept_int64)(~(lept_uint64)0 >> 1))
+#define LEPT_INT64_MIN      (-LEPT_INT64_MAX - 1)
+
+//读取当前字符  到达文本结尾时返回'\0'   '\0'不是任何结构字符  所以调用处只需比较期望的字符
+#define PEEK(c)             ((c)->json != (c)->end ? *(c)->json : '\0')
+
 #define ISDIGIT(ch)         ((ch) >= '0' && (ch) <= '9')
 #define ISDIGIT1TO9(ch)     ((ch) >= '1' && (ch) <= '9')
+#define ISWHITESPACE(ch)    ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
 
 //传入参数  lept_context 一个字符  目的是把这个字符添加到栈中
 #define PUTC(c, ch)         do { *(char*)lept_context_push(c, sizeof(char)) = (ch); } while(0)
@@ -37,29 +185,102 @@
 #define PUTS(c, s, len)     memcpy(lept_context_push(c, len), s, len)
 
 
+struct lept_document {
+	lept_value root;
+	lept_arena arena;
+};
+
+//带引用计数的键  键的内容紧跟在这个结构之后(以'\0'结尾)  对象的成员中存放的是内容的地址
+typedef struct {
+	volatile long refs;
+	size_t len;
+}lept_key_header;
+
+#define LEPT_KEY_HEADER(k)  ((lept_key_header*)(k) - 1)
+
+//键的去重表  开放寻址  线性探测  槽里存放表持有一份引用的键   NULL表示空槽
+typedef struct {
+	lept_uint64 key[2]; //SipHash的密钥  见 lept_object_index
+	char** slots;
+	size_t mask, count;
+}lept_intern;
+
+//可重复使用的解析器  在多次解析之间保留栈  稳定之后解析不再为栈分配内存
+struct lept_parser {
+	char* stack;
+	size_t size;
+	size_t trim_size;  //解析后栈超过这个大小时缩小  避免一次很大的解析一直占用内存
+	int intern_keys;   //不为0时对象的键在 intern 中去重  见 lept_parser_set_intern_keys()
+	lept_intern intern;
+	int validate_utf8; //不为0时检查字符串和键是否是合法的UTF-8  见 lept_parser_set_validate_utf8()
+};
+
+typedef struct lept_two_stage lept_two_stage;  //见 lept_parse_two_stage()
+
 //首先为了减少解析函数之间传递多个参数，
 //我们把这些数据都放进一个 lept_context 结构体：
 typedef struct {
 
 	const char* json;//存放要解析的文本内容
+	const char* end; //文本的结尾(最后一个字符的下一个位置)  解析不会读取它及之后的内容  文本不需要以'\0'结尾
 
 	char* stack; //临时缓冲区  利用堆栈动态数组的数据结构 空间不足时自动扩展
 	size_t size, top;//由于我们会扩展空间大小  如果使用指针存储top会失效   所以用下标的方式存储top
 
+	lept_arena* arena; //解析到lept_document时  字符串/数组/对象从这里分配   为NULL时用malloc
+
+	int insitu; //不为0时文本是可以修改的缓冲区  字符串和键原地解码  直接指向缓冲区
+
+	lept_intern* intern; //不为NULL时对象的键在这里去重  相同的键共用一块带引用计数的内存
+	int validate_utf8;   //不为0时字符串中没有转义的部分必须是合法的UTF-8  \u 转义不能是单独的低代理项
+
+	const lept_handler* handler; //SAX解析时的事件处理函数  见 lept_parse_sax()
+	lept_write_func write;       //流式生成时  栈满之前把已经生成的内容交给 write  见 lept_stringify_to()
+	void* user;                  //原样传给 handler 的每个函数或者 write
+	int error;                   //write 返回的错误  不为0之后不再写入也不再继续生成
+
+	lept_two_stage* stage;       //两阶段解析时第一阶段找出的结构字符的位置  见 lept_parse_two_stage()
+
 }lept_context;
 
+//初始化解析用的 lept_context  栈在第一次压栈时分配
+static void lept_context_init(lept_context* c, lept_arena* arena, int insitu) {
+	c->stack = NULL;
+	c->size = c->top = 0;
+	c->arena = arena;
+	c->insitu = insitu;
+	c->intern = NULL;
+	c->validate_utf8 = 0;
+	c->handler = NULL;
+	c->write = NULL;
+	c->user = NULL;
+	c->error = 0;
+	c->stage = NULL;
+}
+
+//把栈中已经生成的内容交给 write  清空栈
+static void lept_context_flush(lept_context* c) {
+	if (c->top > 0 && !c->error)
+		c->error = c->write(c->user, c->stack, c->top);
+	c->top = 0;
+}
+
 
 //压栈操作  传入  栈  压入数据的大小  返回压入数据的首地址
 static void* lept_context_push(lept_context* c, size_t size) {
 	void* ret;
 	assert(size > 0);
 
+	//流式生成时先把栈中的内容写出去  只有一次压入的数据比整个栈还大时才扩展
+	if (c->top + size >= c->size && c->write)
+		lept_context_flush(c);
+
 	//判断压入数据后大小是否超出栈的大小
 	if (c->top + size >= c->size) {
 		//超出了
 
-		//初始值
-		if (c->size == 0)
+		//初始值  lept_stringify_to() 的缓冲区可能只有几个字节  太小时每次增加 size >> 1 会是0
+		if (c->size < LEPT_PARSE_STACK_INIT_SIZE)
 			c->size = LEPT_PARSE_STACK_INIT_SIZE;
 
 		//循环每次增加到1.5倍 直到足够大
@@ -85,227 +306,2197 @@ static void* lept_context_pop(lept_context* c, size_t size) {
 	return c->stack + (c->top -= size);
 }
 
-
-//空格跳过函数
-static void lept_parse_whitespace(lept_context* c)
-{
-	const char *p = c->json;
-	while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
-		p++;
-	c->json = p;
+//从arena分配size字节  按8字节对齐   当前块不够时分配新的一块  大小是上一块的两倍(至少能放下size)
+void* lept_arena_alloc(lept_arena* a, size_t size) {
+	void* ret;
+	size = (size + 7) & ~(size_t)7;
+	if ((size_t)(a->end - a->cur) < size) {
+		lept_arena_chunk* chunk;
+		size_t chunk_size = a->head ? a->head->size * 2 : LEPT_ARENA_CHUNK_SIZE;
+		if (chunk_size < size)
+			chunk_size = size;
+		chunk = (lept_arena_chunk*)malloc(sizeof(lept_arena_chunk) + chunk_size);
+		chunk->next = a->head;
+		chunk->size = chunk_size;
+		a->head = chunk;
+		a->cur = (char*)(chunk + 1);
+		a->end = a->cur + chunk_size;
+	}
+	ret = a->cur;
+	a->cur += size;
+	return ret;
 }
 
+//释放除最新(最大)一块以外的所有块  留下的一块给下一次解析使用
+void lept_arena_reset(lept_arena* a) {
+	lept_arena_chunk* chunk;
+	if (a->head == NULL)
+		return;
+	while ((chunk = a->head->next) != NULL) {
+		a->head->next = chunk->next;
+		free(chunk);
+	}
+	a->cur = (char*)(a->head + 1);
+	a->end = a->cur + a->head->size;
+}
 
-//解析  null  true  false  的函数
-static int lept_parse_literal(lept_context* c, lept_value* v, const char* literal, lept_type type)
-{
-	size_t i;
-	EXPECT(c, literal[0]);
-
-	for (i = 0; literal[i + 1]; i++)
-	{
-		if (c->json[i] != literal[i + 1])
-			return LEPT_PARSE_INVALID_VALUE;
+//释放所有块
+void lept_arena_free(lept_arena* a) {
+	lept_arena_chunk* chunk;
+	while ((chunk = a->head) != NULL) {
+		a->head = chunk->next;
+		free(chunk);
 	}
+	a->cur = a->end = NULL;
+}
 
-	//解析成功   是null false true中的一个
-	c->json += i;//指针移动到下个值的首地址
-	v->type = type;//类型改为预期值类型
+//解析结果的内存  解析到lept_document时从arena分配  否则用malloc
+static void* lept_context_alloc(lept_context* c, size_t size) {
+	return c->arena ? lept_arena_alloc(c->arena, size) : malloc(size);
+}
 
-	return LEPT_PARSE_OK;
+//复制一个字符串并在末尾加上'\0'  用于字符串的值和对象的键
+static char* lept_context_strdup(lept_context* c, const char* s, size_t len) {
+	char* ret = (char*)lept_context_alloc(c, len + 1);
+	if (len)
+		memcpy(ret, s, len);
+	ret[len] = '\0';
+	return ret;
 }
 
+//分配一个引用计数为1的键
+static char* lept_key_new(const char* s, size_t len) {
+	lept_key_header* h = (lept_key_header*)malloc(sizeof(lept_key_header) + len + 1);
+	char* k = (char*)(h + 1);
+	h->refs = 1;
+	h->len = len;
+	memcpy(k, s, len);
+	k[len] = '\0';
+	return k;
+}
 
-//解析number
-static int lept_parse_number(lept_context* c, lept_value* v) {
+static char* lept_key_retain(char* k) {
+	LEPT_ATOMIC_INC(&LEPT_KEY_HEADER(k)->refs);
+	return k;
+}
 
-	/*   JOSN number类型
-	number = [ "-" ] int [ frac ] [ exp ]
-	int = "0" / digit1-9 *digit
-	frac = "." 1*digit
-	exp = ("e" / "E") ["-" / "+"] 1*digit
-	*/
+static void lept_key_release(char* k) {
+	if (LEPT_ATOMIC_DEC(&LEPT_KEY_HEADER(k)->refs) == 0)
+		free(LEPT_KEY_HEADER(k));
+}
 
-	const char* p = c->json;
-	if (*p == '-') p++;
-	if (*p == '0') p++;
-	else {
-		//符号后不能只有0
-		if (!ISDIGIT1TO9(*p))
-			return LEPT_PARSE_INVALID_VALUE;
 
-		for (p++; ISDIGIT(*p); p++);
-	}
-	if (*p == '.') {
-		p++;
-		//点后边没数
-		if (!ISDIGIT(*p))
-			return LEPT_PARSE_INVALID_VALUE;
+#ifdef LEPT_SIMD_SSE2
+//返回最低位的1的位置  x 不能为0
+static unsigned lept_ctz(unsigned x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_ctz(x);
+#elif defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, x);
+	return (unsigned)i;
+#else
+	unsigned i = 0;
+	while (!(x & 1)) { x >>= 1; i++; }
+	return i;
+#endif
+}
+#endif
 
-		for (p++; ISDIGIT(*p); p++);
-	}
-	if (*p == 'e' || *p == 'E') {
-		p++;
-		if (*p == '+' || *p == '-') p++;
-		if (!ISDIGIT(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
+#ifdef LEPT_SIMD_AVX2
+//检测CPU和操作系统是否都支持AVX2  (操作系统需要在线程切换时保存YMM寄存器)  结果缓存起来
+static int lept_cpu_has_avx2(void) {
+	static int has_avx2 = -1;
+	if (has_avx2 < 0) {
+#ifdef _MSC_VER
+		int info[4];
+		has_avx2 = 0;
+		__cpuid(info, 0);
+		if (info[0] >= 7) {
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6) { /* OSXSAVE, XMM|YMM */
+				__cpuidex(info, 7, 0);
+				has_avx2 = (info[1] & (1 << 5)) != 0;
+			}
+		}
+#else
+		__builtin_cpu_init();
+		has_avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
 	}
+	return has_avx2;
+}
+#endif
 
-	//解析number成功
-	errno = 0;
-
-	//strtod() 可转换 JSON 所要求的格式  把十进制的数字转换成二进制的 double
-	//解析不成功   
-	v->u.n = strtod(c->json, NULL);
+//扫描函数  参数p指向第一个需要检查的字符  end为文本结尾  返回第一个不满足条件的字符的地址  都满足时返回end
+typedef const char* (*lept_scan_func)(const char* p, const char* end);
 
-	// 如果errno=ERANGE 说明范围错误数字过大
-	if (errno == ERANGE && (v->u.n == HUGE_VAL || v->u.n == -HUGE_VAL))
-		return LEPT_PARSE_NUMBER_TOO_BIG;
+//跳过空白的几种实现  返回第一个非空白字符的地址
 
-	//数据类型变  指针位置变
-	v->type = LEPT_NUMBER;
-	c->json = p;
+static const char* lept_skip_whitespace_scalar(const char* p, const char* end) {
+	while (p != end && ISWHITESPACE(*p))
+		p++;
+	return p;
+}
 
-	return LEPT_PARSE_OK;
+#ifdef LEPT_SIMD_SSE2
+//一次比较16个字节   先把指针向下对齐到16字节边界再读取
+//只读取起始地址在end之前的块  对齐的块不会跨越内存页  而块中至少有一个字节属于文本  所以不会访问非法内存  (和strlen的做法一样)
+//多读的字节会被忽略   但AddressSanitizer会误报  因此关闭该函数的检查
+LEPT_NO_SANITIZE
+static const char* lept_skip_whitespace_sse2(const char* p, const char* end) {
+	const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+	const __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+	const char* q = (const char*)((size_t)p & ~(size_t)15);
+	unsigned mask = 0xFFFFu << (p - q);//对齐前的字节不算
+	for (; q < end; q += 16) {
+		__m128i s = _mm_load_si128((const __m128i*)q);
+		__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(s, sp), _mm_cmpeq_epi8(s, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(s, lf), _mm_cmpeq_epi8(s, cr)));
+		//mask中为1的位就是非空白字符
+		mask &= ~(unsigned)_mm_movemask_epi8(ws) & 0xFFFFu;
+		if (mask) {
+			q += lept_ctz(mask);
+			return q < end ? q : end;
+		}
+		mask = 0xFFFFu;
+	}
+	return end;
 }
+#endif
 
-//检验  /u后是否时4位有效数字   传入json 和一个存放解析成功转化的十进制数
-static const char* lept_parse_hex4(const char* p, unsigned* u) {
-	int i;
-	*u = 0;
-	for (i = 0; i < 4; i++) {
+#ifdef LEPT_SIMD_AVX2
+//与SSE2版本相同  一次比较32个字节
+LEPT_TARGET_AVX2 LEPT_NO_SANITIZE
+static const char* lept_skip_whitespace_avx2(const char* p, const char* end) {
+	const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+	const __m256i lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+	const char* q = (const char*)((size_t)p & ~(size_t)31);
+	unsigned mask = 0xFFFFFFFFu << (p - q);
+	for (; q < end; q += 32) {
+		__m256i s = _mm256_load_si256((const __m256i*)q);
+		__m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(s, sp), _mm256_cmpeq_epi8(s, tab)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(s, lf), _mm256_cmpeq_epi8(s, cr)));
+		mask &= ~(unsigned)_mm256_movemask_epi8(ws);
+		if (mask) {
+			q += lept_ctz(mask);
+			return q < end ? q : end;
+		}
+		mask = 0xFFFFFFFFu;
+	}
+	return end;
+}
+#endif
 
-		char ch = *p++;
+//第一次调用时检测CPU  选出最快的实现并替换函数指针   之后直接调用选中的实现   见 lept_init_dispatch()
+static const char* lept_skip_whitespace_init(const char* p, const char* end);
+static lept_scan_func lept_skip_whitespace = lept_skip_whitespace_init;
 
-		*u <<= 4;//每次将数扩大2的4次方  相当于解析对应十六进制的一个字符
+static const char* lept_skip_whitespace_init(const char* p, const char* end) {
+	lept_init_dispatch();
+	return lept_skip_whitespace(p, end);
+}
 
-		//将每个字符转化位对应的十进制数
-		if (ch >= '0' && ch <= '9')  *u |= ch - '0';
-		else if (ch >= 'A' && ch <= 'F')  *u |= ch - ('A' - 10);
-		else if (ch >= 'a' && ch <= 'f')  *u |= ch - ('a' - 10);
+//扫描字符串中可以直接复制的字符  返回第一个 '"'  '\\'  或控制字符的地址
+static const char* lept_scan_string_scalar(const char* p, const char* end) {
+	while (p != end && *p != '\"' && *p != '\\' && (unsigned char)*p >= 0x20)
+		p++;
+	return p;
+}
 
-		//字符无效转化失败
-		else return NULL;
+#ifdef LEPT_SIMD_SSE2
+//SSE2只有有符号比较  用 max_epu8(s, 0x1F) == 0x1F 判断无符号的 s <= 0x1F
+LEPT_NO_SANITIZE
+static const char* lept_scan_string_sse2(const char* p, const char* end) {
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+	const char* q = (const char*)((size_t)p & ~(size_t)15);
+	unsigned mask = 0xFFFFu << (p - q);
+	for (; q < end; q += 16) {
+		__m128i s = _mm_load_si128((const __m128i*)q);
+		__m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(s, quote), _mm_cmpeq_epi8(s, backslash)),
+			_mm_cmpeq_epi8(_mm_max_epu8(s, ctrl), ctrl));
+		mask &= (unsigned)_mm_movemask_epi8(stop);
+		if (mask) {
+			q += lept_ctz(mask);
+			return q < end ? q : end;
+		}
+		mask = 0xFFFFu;
 	}
-	//解析成功
-	return p;
+	return end;
 }
+#endif
 
-//解析UTF-8编码格式  传入lept_context 和 解析Unicode所得的十进制数
-static void lept_encode_utf8(lept_context* c, unsigned u) {
-	//char，为什么要做 x & 0xFF 这种操作呢？
-	//这是因为 u 是 unsigned 类型，
-	//一些编译器可能会警告这个转型可能会截断数据。
-	//但实际上，配合了范围的检测然后右移之后，
-	//可以保证写入的是 0~255 内的值。
-	//为了避免一些编译器的警告误判，
-	//我们加上 u & 0xFF
+#ifdef LEPT_SIMD_AVX2
+LEPT_TARGET_AVX2 LEPT_NO_SANITIZE
+static const char* lept_scan_string_avx2(const char* p, const char* end) {
+	const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), ctrl = _mm256_set1_epi8(0x1F);
+	const char* q = (const char*)((size_t)p & ~(size_t)31);
+	unsigned mask = 0xFFFFFFFFu << (p - q);
+	for (; q < end; q += 32) {
+		__m256i s = _mm256_load_si256((const __m256i*)q);
+		__m256i stop = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(s, quote), _mm256_cmpeq_epi8(s, backslash)),
+			_mm256_cmpeq_epi8(_mm256_max_epu8(s, ctrl), ctrl));
+		mask &= (unsigned)_mm256_movemask_epi8(stop);
+		if (mask) {
+			q += lept_ctz(mask);
+			return q < end ? q : end;
+		}
+		mask = 0xFFFFFFFFu;
+	}
+	return end;
+}
+#endif
 
+static const char* lept_scan_string_init(const char* p, const char* end);
+static lept_scan_func lept_scan_string = lept_scan_string_init;
 
-	//码点范围：U+0000-U+007F	 码点位数：7	  字节1：0xxxxxxx	
-	if (u <= 0x7F)
-		PUTC(c, u & 0xFF);
+static const char* lept_scan_string_init(const char* p, const char* end) {
+	lept_init_dispatch();
+	return lept_scan_string(p, end);
+}
 
-	//码点范围：U+0080 ~ U+07FF	   码点位数：11	    字节1：110xxxxx 字节2：10xxxxxx	
-	else if (u <= 0x7FF) {
-		PUTC(c, 0xC0 | ((u >> 6) & 0xFF));
-		PUTC(c, 0x80 | (u & 0x3F));
+//打开UTF-8校验时使用的扫描  与 lept_scan_string() 相同  返回第一个 '"'  '\\'  或控制字符的地址  同时校验经过的非ASCII字符
+//遇到不合法的UTF-8时返回NULL   见 lept_parser_set_validate_utf8()
+//合法的字节序列(Unicode标准 Table 3-7)  排除了过长编码  代理项(U+D800 ~ U+DFFF) 和大于 U+10FFFF 的码点
+//  U+0000   ~ U+007F     00..7F
+//  U+0080   ~ U+07FF     C2..DF  80..BF
+//  U+0800   ~ U+0FFF     E0      A0..BF  80..BF
+//  U+1000   ~ U+CFFF     E1..EC  80..BF  80..BF
+//  U+D000   ~ U+D7FF     ED      80..9F  80..BF
+//  U+E000   ~ U+FFFF     EE..EF  80..BF  80..BF
+//  U+10000  ~ U+3FFFF    F0      90..BF  80..BF  80..BF
+//  U+40000  ~ U+FFFFF    F1..F3  80..BF  80..BF  80..BF
+//  U+100000 ~ U+10FFFF   F4      80..8F  80..BF  80..BF
+
+//校验从p开始的一个非ASCII字符  返回下一个字符的地址  不合法时返回NULL
+static const char* lept_validate_utf8_char(const char* p, const char* end) {
+	const unsigned char* s = (const unsigned char*)p;
+	size_t n = (size_t)(end - p);
+	unsigned char lo = 0x80, hi = 0xBF;//第二个字节的范围
+	if (s[0] >= 0xC2 && s[0] <= 0xDF)
+		return n >= 2 && (s[1] & 0xC0) == 0x80 ? p + 2 : NULL;
+	if (s[0] >= 0xE0 && s[0] <= 0xEF) {
+		if (s[0] == 0xE0)
+			lo = 0xA0;
+		else if (s[0] == 0xED)
+			hi = 0x9F;
+		return n >= 3 && s[1] >= lo && s[1] <= hi && (s[2] & 0xC0) == 0x80 ? p + 3 : NULL;
+	}
+	if (s[0] >= 0xF0 && s[0] <= 0xF4) {
+		if (s[0] == 0xF0)
+			lo = 0x90;
+		else if (s[0] == 0xF4)
+			hi = 0x8F;
+		return n >= 4 && s[1] >= lo && s[1] <= hi && (s[2] & 0xC0) == 0x80 && (s[3] & 0xC0) == 0x80 ? p + 4 : NULL;
 	}
+	return NULL;
+}
 
-	//码点范围：U+0800 ~ U+FFFF	 码点位数：16	  字节1：110xxxxx 字节2：10xxxxxx  字节3：10xxxxxx
-	else if (u <= 0xFFFF) {
-		PUTC(c, 0xE0 | ((u >> 12) & 0xFF));
-		PUTC(c, 0x80 | ((u >> 6) & 0x3F));
-		PUTC(c, 0x80 | (u & 0x3F));
+//扫描ASCII字符  除了 '"'  '\\'  控制字符  也在第一个非ASCII字符处停下
+static const char* lept_scan_ascii_scalar(const char* p, const char* end) {
+	while (p != end && *p != '\"' && *p != '\\' && (unsigned char)*p >= 0x20 && (unsigned char)*p < 0x80)
+		p++;
+	return p;
+}
+
+//ASCII字符用 ascii 扫描  遇到非ASCII字符时逐个校验
+static const char* lept_scan_utf8_with(lept_scan_func ascii, const char* p, const char* end) {
+	for (;;) {
+		p = ascii(p, end);
+		if (p == end || (unsigned char)*p < 0x80)
+			return p;
+		do {
+			if (!(p = lept_validate_utf8_char(p, end)))
+				return NULL;
+		} while (p != end && (unsigned char)*p >= 0x80);
 	}
+}
 
-	//码点范围：U+10000 ~ U+10FFFF	 码点位数：21	  字节1：11110xxx  字节2：10xxxxxx  字节3：10xxxxxx	 字节4：10xxxxxx
-	else {
-		assert(u <= 0x10FFFF);
-		PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
-		PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-		PUTC(c, 0x80 | ((u >> 6) & 0x3F));
-		PUTC(c, 0x80 | (u & 0x3F));
+static const char* lept_scan_utf8_scalar(const char* p, const char* end) {
+	return lept_scan_utf8_with(lept_scan_ascii_scalar, p, end);
+}
+
+#ifdef LEPT_SIMD_SSE2
+//按有符号比较  小于0x20的就是控制字符和大于等于0x80的字节
+//SSE2没有查表指令(pshufb)  不能像AVX2版本那样整块校验  非ASCII字符逐个校验
+LEPT_NO_SANITIZE
+static const char* lept_scan_ascii_sse2(const char* p, const char* end) {
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), space = _mm_set1_epi8(0x20);
+	const char* q = (const char*)((size_t)p & ~(size_t)15);
+	unsigned mask = 0xFFFFu << (p - q);
+	for (; q < end; q += 16) {
+		__m128i s = _mm_load_si128((const __m128i*)q);
+		__m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(s, quote), _mm_cmpeq_epi8(s, backslash)),
+			_mm_cmplt_epi8(s, space));
+		mask &= (unsigned)_mm_movemask_epi8(stop);
+		if (mask) {
+			q += lept_ctz(mask);
+			return q < end ? q : end;
+		}
+		mask = 0xFFFFu;
 	}
+	return end;
 }
 
-//传入解析结果   更新top直接跳过此字符   重构返回错误吗的处理抽取为宏
-#define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
+static const char* lept_scan_utf8_sse2(const char* p, const char* end) {
+	return lept_scan_utf8_with(lept_scan_ascii_sse2, p, end);
+}
+#endif
 
-//解析 JSON 字符串，把结果写入 str 和 len  str 指向 c->stack 中的元素，需要在 c->stack
-//这样的话，我们实现对象的解析时，就可以使用 lept_parse_string_raw()　来解析 JSON 字符串，然后把结果复制至 lept_member 的 k 和 klen 字段。
-static int lept_parse_string_raw(lept_context* c, char** str, size_t* len) {
+#ifdef LEPT_SIMD_AVX2
+//查表校验(John Keiser, Daniel Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte", 2021)
+//每个字节和它前面的一个字节  按 前一个字节的高4位  前一个字节的低4位  这个字节的高4位 查3张表
+//每张表的结果的每一位代表一种错误  3个结果按位与之后不为0就是遇到了这种错误
+//再用前面第2 3个字节检查3 4字节字符的后两个字节是否是延续字节   最后检查结尾的字符是否完整
+#define LEPT_UTF8_TOO_SHORT      (1 << 0) //11______ 后面不是 10______
+#define LEPT_UTF8_TOO_LONG       (1 << 1) //0_______ 后面是 10______
+#define LEPT_UTF8_OVERLONG_3     (1 << 2) //11100000 100_____
+#define LEPT_UTF8_TOO_LARGE      (1 << 3) //11110100 1001____  11110100 101_____  11110101 ~ 11111111
+#define LEPT_UTF8_SURROGATE      (1 << 4) //11101101 101_____
+#define LEPT_UTF8_OVERLONG_2     (1 << 5) //1100000_ 10______
+#define LEPT_UTF8_TOO_LARGE_1000 (1 << 6) //11110101 ~ 11111111 后面是 1000____
+#define LEPT_UTF8_OVERLONG_4     (1 << 6) //11110000 1000____
+#define LEPT_UTF8_TWO_CONTS      (-128)   //(1 << 7)  _mm256_setr_epi8() 的参数是char  写成负数  10______ 10______  (由第2 3个字节的检查排除合法的情况)
+#define LEPT_UTF8_CARRY          (LEPT_UTF8_TOO_SHORT | LEPT_UTF8_TOO_LONG | LEPT_UTF8_TWO_CONTS)
+
+//a 前面 n 个字节开始的32个字节   prev 为上一块
+#define LEPT_AVX2_PREV(a, prev, n) _mm256_alignr_epi8(a, _mm256_permute2x128_si256(prev, a, 0x21), 16 - (n))
+
+LEPT_TARGET_AVX2
+static __m256i lept_validate_utf8_block(__m256i in, __m256i prev) {
+	const __m256i byte_1_high_table = _mm256_setr_epi8(
+		//0_______ ________    ASCII后面不能是延续字节
+		LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG,
+		LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG,
+		//10______ ________
+		LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS,
+		//1100____ ________
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_OVERLONG_2,
+		//1101____ ________
+		LEPT_UTF8_TOO_SHORT,
+		//1110____ ________
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_SURROGATE,
+		//1111____ ________
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_OVERLONG_4,
+		LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG,
+		LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG,
+		LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS,
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_OVERLONG_2,
+		LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_SURROGATE,
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_OVERLONG_4);
+	const __m256i byte_1_low_table = _mm256_setr_epi8(
+		//____0000 ________
+		LEPT_UTF8_CARRY | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_OVERLONG_4,
+		//____0001 ________
+		LEPT_UTF8_CARRY | LEPT_UTF8_OVERLONG_2,
+		//____001_ ________
+		LEPT_UTF8_CARRY, LEPT_UTF8_CARRY,
+		//____0100 ________
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE,
+		//____0101 ~ ____1100 ________
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		//____1101 ________
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_SURROGATE,
+		//____111_ ________
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_OVERLONG_4,
+		LEPT_UTF8_CARRY | LEPT_UTF8_OVERLONG_2,
+		LEPT_UTF8_CARRY, LEPT_UTF8_CARRY,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_SURROGATE,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000);
+	const __m256i byte_2_high_table = _mm256_setr_epi8(
+		//________ 0_______
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		//________ 1000____
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_OVERLONG_4,
+		//________ 1001____
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_TOO_LARGE,
+		//________ 101_____
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_SURROGATE | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_SURROGATE | LEPT_UTF8_TOO_LARGE,
+		//________ 11______
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_OVERLONG_4,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_SURROGATE | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_SURROGATE | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT);
+	const __m256i low4 = _mm256_set1_epi8(0x0F);
+	__m256i prev1 = LEPT_AVX2_PREV(in, prev, 1);
+	__m256i special = _mm256_and_si256(_mm256_and_si256(
+		_mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low4)),
+		_mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, low4))),
+		_mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(in, 4), low4)));
+	//前面第2个字节是 111_____ 或者前面第3个字节是 1111____ 时  这个字节必须是延续字节   正好与 TWO_CONTS 的结果相同
+	__m256i must23 = _mm256_or_si256(
+		_mm256_subs_epu8(LEPT_AVX2_PREV(in, prev, 2), _mm256_set1_epi8((char)(0xE0 - 0x80))),
+		_mm256_subs_epu8(LEPT_AVX2_PREV(in, prev, 3), _mm256_set1_epi8((char)(0xF0 - 0x80))));
+	return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80)), special);
+}
 
-	size_t head = c->top;//标记此时还没push栈的top   用于解析过程中失败从而还原top值
-	unsigned u, u2;
-	const char* p;
+//最后3个字节是否有还没有结束的字符   不为0表示有
+LEPT_TARGET_AVX2
+static __m256i lept_utf8_incomplete(__m256i in) {
+	const __m256i max = _mm256_setr_epi8(
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+	return _mm256_subs_epu8(in, max);
+}
 
-	EXPECT(c, '\"');//跳过 "
-	p = c->json;
+//一次处理32个字节  找出需要特殊处理的字符的同时查表校验   全是ASCII的块只需要检查上一块结尾的字符是否完整
+//找到需要特殊处理的字符时  把它和之后的字节换成0再校验  它前面不完整的字符会被当作 TOO_SHORT
+//不满32个字节的结尾复制到缓冲区中  后面补上引号   只在文本的结尾发生一次
+LEPT_TARGET_AVX2
+static const char* lept_scan_utf8_avx2(const char* p, const char* end) {
+	const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), ctrl = _mm256_set1_epi8(0x1F);
+	const __m256i index = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+	__m256i prev = _mm256_setzero_si256(), error = prev, incomplete = prev, in;
+	char tail[32];
+	size_t n;
+	unsigned stop, high;
+	for (;; p += 32) {
+		if (end - p >= 32)
+			in = _mm256_loadu_si256((const __m256i*)p);
+		else {
+			n = (size_t)(end - p);
+			memcpy(tail, p, n);
+			memset(tail + n, '"', sizeof(tail) - n);//结尾当作遇到了引号
+			in = _mm256_loadu_si256((const __m256i*)tail);
+		}
+		stop = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(in, quote),
+			_mm256_cmpeq_epi8(in, backslash)), _mm256_cmpeq_epi8(_mm256_max_epu8(in, ctrl), ctrl)));
+		high = (unsigned)_mm256_movemask_epi8(in);
+		if (stop) {
+			n = lept_ctz(stop);
+			if ((high & ((1u << n) - 1)) == 0)
+				error = _mm256_or_si256(error, incomplete);
+			else
+				error = _mm256_or_si256(error, lept_validate_utf8_block(
+					_mm256_and_si256(in, _mm256_cmpgt_epi8(_mm256_set1_epi8((char)n), index)), prev));
+			return _mm256_testz_si256(error, error) ? p + n : NULL;
+		}
+		if (high == 0)
+			error = _mm256_or_si256(error, incomplete);
+		else {
+			error = _mm256_or_si256(error, lept_validate_utf8_block(in, prev));
+			incomplete = lept_utf8_incomplete(in);
+		}
+		prev = in;
+	}
+}
+#endif
 
-	for (;;) {
-		char ch = *p++;
-		switch (ch) {
+static const char* lept_scan_utf8_init(const char* p, const char* end);
+static lept_scan_func lept_scan_utf8 = lept_scan_utf8_init;
 
-			//表示字符串的结束
-		case '\"':
-			*len = c->top - head;//字符串的长度
-			*str = lept_context_pop(c, *len);//出栈后的头指针
-			c->json = p;//移动文本指针
-			return LEPT_PARSE_OK;//成功
+static const char* lept_scan_utf8_init(const char* p, const char* end) {
+	lept_init_dispatch();
+	return lept_scan_utf8(p, end);
+}
 
-		//转移字符
-		case '\\':
-			switch (*p++) {
-			case '\"': PUTC(c, '\"'); break;
-			case '\\': PUTC(c, '\\'); break;
-			case '/':  PUTC(c, '/'); break;
-			case 'b':  PUTC(c, '\b'); break;
-			case 'f':  PUTC(c, '\f'); break;
-			case 'n':  PUTC(c, '\n'); break;
-			case 'r':  PUTC(c, '\r'); break;
-			case 't':  PUTC(c, '\t'); break;
+//两阶段解析的第一阶段  一次处理64个字节  为每一类字符求出64位的掩码  第i位对应块中第i个字节
+//然后用位运算求出哪些引号被转义  哪些字节在字符串中  最后得到所有结构字符的位置
+//结构字符是字符串外的 {}[]:,  字符串的开始和结束引号  以及空白或结构字符之后第一个非空白字节(标量的开始)
+typedef struct {
+	lept_uint64 backslash, quote, ws, op;
+	lept_uint64 ctrl;  //小于0x20的字节  在字符串中不合法
+}lept_block;
+
+//返回最低位的1的位置  x 不能为0
+static unsigned lept_ctz64(lept_uint64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return (unsigned)i;
+#else
+	unsigned i = 0;
+	while (!(x & 1)) { x >>= 1; i++; }
+	return i;
+#endif
+}
 
-				//Unicode码转十进制再转UTF-8编码格式
-			case 'u':
+//in_string 不为0时块的开始在字符串中   如果整块都没有引号  反斜杠和控制字符  这一块都在字符串中  可以不求 ws 和 op
+typedef void (*lept_classify_func)(const char* p, lept_block* b, int in_string);
 
-				//先将十六进制转化位十进制数存入u中
-				if (!(p = lept_parse_hex4(p, &u)))
-					STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
+static void lept_classify_scalar(const char* p, lept_block* b, int in_string) {
+	lept_uint64 bit = 1;
+	int i;
+	b->backslash = b->quote = b->ws = b->op = b->ctrl = 0;
+	//和SIMD版本一样  块在字符串中时先找引号  反斜杠和控制字符  都没有就不用逐个分类
+	if (in_string) {
+		for (i = 0; i < 64; i++)
+			if (p[i] == '"' || p[i] == '\\' || (unsigned char)p[i] < 0x20)
+				break;
+		if (i == 64)
+			return;
+	}
+	for (i = 0; i < 64; i++, bit <<= 1)
+		switch (p[i]) {
+		case ' ':                                              b->ws |= bit; break;
+		case '\t': case '\n': case '\r':                        b->ws |= bit; b->ctrl |= bit; break;
+		case '{': case '}': case '[': case ']': case ':': case ',': b->op |= bit; break;
+		case '"':  b->quote |= bit; break;
+		case '\\': b->backslash |= bit; break;
+		default:   if ((unsigned char)p[i] < 0x20) b->ctrl |= bit; break;
+		}
+}
 
-				//U+0000 至 U+FFFF 这组 Unicode 字符称为基本多文种平面（basic multilingual plane, BMP），
-				//还有另外 16 个平面。
-				//那么 BMP 以外的字符，JSON 会使用代理对（surrogate pair）表示 \uXXXX\uYYYY。
-				//在 BMP 中，保留了 2048 个代理码点。
+#ifdef LEPT_SIMD_SSE2
+//'[' ']' 和 0x20 按位或之后是 '{' '}'   4个括号只需要比较两次
+static void lept_classify_sse2(const char* p, lept_block* b, int in_string) {
+	const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+	const __m128i lower = _mm_set1_epi8(0x20), lbrace = _mm_set1_epi8('{'), rbrace = _mm_set1_epi8('}');
+	const __m128i colon = _mm_set1_epi8(':'), comma = _mm_set1_epi8(',');
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+	int i;
+	b->backslash = b->quote = b->ws = b->op = b->ctrl = 0;
+	for (i = 0; i < 64; i += 16) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(p + i));
+		b->quote |= (lept_uint64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(s, quote)) << i;
+		b->backslash |= (lept_uint64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(s, backslash)) << i;
+		b->ctrl |= (lept_uint64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(s, ctrl), s)) << i;
+	}
+	if (in_string && !(b->quote | b->backslash | b->ctrl))
+		return;
+	for (i = 0; i < 64; i += 16) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(p + i)), l = _mm_or_si128(s, lower);
+		__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(s, sp), _mm_cmpeq_epi8(s, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(s, lf), _mm_cmpeq_epi8(s, cr)));
+		__m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(l, lbrace), _mm_cmpeq_epi8(l, rbrace)),
+			_mm_or_si128(_mm_cmpeq_epi8(s, colon), _mm_cmpeq_epi8(s, comma)));
+		b->ws |= (lept_uint64)(unsigned)_mm_movemask_epi8(ws) << i;
+		b->op |= (lept_uint64)(unsigned)_mm_movemask_epi8(op) << i;
+	}
+}
+#endif
 
-				//如果第一个码点是U+D800 至 U+DBFF  它的代码对的高代理项 （high surrogate）
-				if (u >= 0xD800 && u <= 0xDBFF) { /* surrogate pair */
+#ifdef LEPT_SIMD_AVX2
+LEPT_TARGET_AVX2
+static void lept_classify_avx2(const char* p, lept_block* b, int in_string) {
+	const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t'), lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+	const __m256i lower = _mm256_set1_epi8(0x20), lbrace = _mm256_set1_epi8('{'), rbrace = _mm256_set1_epi8('}');
+	const __m256i colon = _mm256_set1_epi8(':'), comma = _mm256_set1_epi8(',');
+	const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), ctrl = _mm256_set1_epi8(0x1F);
+	__m256i s0 = _mm256_loadu_si256((const __m256i*)p), s1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+	__m256i ws, op, l;
+	b->quote = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(s0, quote))
+		| (lept_uint64)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(s1, quote)) << 32;
+	b->backslash = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(s0, backslash))
+		| (lept_uint64)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(s1, backslash)) << 32;
+	b->ctrl = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(s0, ctrl), s0))
+		| (lept_uint64)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(s1, ctrl), s1)) << 32;
+	if (in_string && !(b->quote | b->backslash | b->ctrl)) {
+		b->ws = b->op = 0;
+		return;
+	}
+	ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(s0, sp), _mm256_cmpeq_epi8(s0, tab)),
+		_mm256_or_si256(_mm256_cmpeq_epi8(s0, lf), _mm256_cmpeq_epi8(s0, cr)));
+	l = _mm256_or_si256(s0, lower);
+	op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(l, lbrace), _mm256_cmpeq_epi8(l, rbrace)),
+		_mm256_or_si256(_mm256_cmpeq_epi8(s0, colon), _mm256_cmpeq_epi8(s0, comma)));
+	b->ws = (unsigned)_mm256_movemask_epi8(ws);
+	b->op = (unsigned)_mm256_movemask_epi8(op);
+	ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(s1, sp), _mm256_cmpeq_epi8(s1, tab)),
+		_mm256_or_si256(_mm256_cmpeq_epi8(s1, lf), _mm256_cmpeq_epi8(s1, cr)));
+	l = _mm256_or_si256(s1, lower);
+	op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(l, lbrace), _mm256_cmpeq_epi8(l, rbrace)),
+		_mm256_or_si256(_mm256_cmpeq_epi8(s1, colon), _mm256_cmpeq_epi8(s1, comma)));
+	b->ws |= (lept_uint64)(unsigned)_mm256_movemask_epi8(ws) << 32;
+	b->op |= (lept_uint64)(unsigned)_mm256_movemask_epi8(op) << 32;
+}
+#endif
 
-					//之后应该伴随一个 U+DC00 至 U+DFFF 的低代理项（low surrogate）
-					if (*p++ != '\\')
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					if (*p++ != 'u')
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+static void lept_classify_init(const char* p, lept_block* b, int in_string);
+static lept_classify_func lept_classify = lept_classify_init;
 
-					//再次解析一个 \u后是否是4位十六进位数字
-					if (!(p = lept_parse_hex4(p, &u2)))
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
+static void lept_classify_init(const char* p, lept_block* b, int in_string) {
+	lept_init_dispatch();
+	lept_classify(p, b, in_string);
+}
 
-					//U+DC00 至 U+DFFF 的低代理项
-					if (u2 < 0xDC00 || u2 > 0xDFFF)
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+//检测CPU  一次选好所有扫描函数的实现   写入的值总是相同的  但多个线程同时第一次解析时会同时写这些函数指针
+//所以多线程使用前要先调用一次   lept_ndjson_parse() 在创建线程前会调用
+void lept_init_dispatch(void) {
+	lept_scan_func ws = lept_skip_whitespace_scalar, str = lept_scan_string_scalar, utf8 = lept_scan_utf8_scalar;
+	lept_classify_func cls = lept_classify_scalar;
+#ifdef LEPT_SIMD_SSE2
+	ws = lept_skip_whitespace_sse2;
+	str = lept_scan_string_sse2;
+	utf8 = lept_scan_utf8_sse2;
+	cls = lept_classify_sse2;
+#endif
+#ifdef LEPT_SIMD_AVX2
+	if (lept_cpu_has_avx2()) {
+		ws = lept_skip_whitespace_avx2;
+		str = lept_scan_string_avx2;
+		utf8 = lept_scan_utf8_avx2;
+		cls = lept_classify_avx2;
+	}
+#endif
+	lept_skip_whitespace = ws;
+	lept_scan_string = str;
+	lept_scan_utf8 = utf8;
+	lept_classify = cls;
+}
 
-					//我们用下列公式把代理对 (H, L) 变换成真实的码点：
-					//codepoint = 0x10000 + (H − 0xD800) × 0x400 + (L − 0xDC00)
-					u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
+//块之间传递的状态
+typedef struct {
+	lept_uint64 odd_backslash; //上一块以奇数个连续的反斜杠结尾  这一块的第一个字节被转义
+	lept_uint64 in_string;     //上一块结尾在字符串中  全1或者全0
+	lept_uint64 scalar_pred;   //上一块的最后一个字节是空白或结构字符
+	int dirty;                 //上一块结尾所在的字符串中已经出现了转义或控制字符
+}lept_stage1;
+
+#define LEPT_EVEN_BITS 0x5555555555555555ULL
+
+//求被奇数个连续反斜杠转义的字节  (每一段连续的反斜杠从开始的位置两两配对  长度为奇数时后面的一个字节被转义)
+//按段开始位置的奇偶分开  加上段的开始位置  进位恰好停在段的结尾之后   结尾和开始的奇偶不同  说明段的长度是奇数
+//上一块以奇数段结尾时  这一块开始的反斜杠接着那一段  所以第0位按奇数位开始算
+static lept_uint64 lept_stage1_escaped(lept_stage1* s, lept_uint64 backslash) {
+	lept_uint64 starts = backslash & ~(backslash << 1);
+	lept_uint64 even_mask = LEPT_EVEN_BITS ^ s->odd_backslash;
+	lept_uint64 even_carries = backslash + (starts & even_mask);
+	lept_uint64 odd_carries = backslash + (starts & ~even_mask);
+	lept_uint64 carry_out = odd_carries < backslash;  //奇数位开始的一段一直延续到块的结尾
+	odd_carries |= s->odd_backslash;
+	s->odd_backslash = carry_out;
+	return (even_carries & ~backslash & ~LEPT_EVEN_BITS) | (odd_carries & ~backslash & LEPT_EVEN_BITS);
+}
 
-				}
+//前缀异或  第i位是x的第0到i位的异或   引号之间(包括开始的引号  不包括结束的引号)都是1
+static lept_uint64 lept_prefix_xor(lept_uint64 x) {
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
 
-				//转化为UTF-8编码格式
-				lept_encode_utf8(c, u);
-				break;
-			default:
-				//转移无效  更新top 跳过字符串
+//求一块中所有结构字符的掩码   close 是结束引号  dirty 是字符串中的反斜杠和控制字符
+static lept_uint64 lept_stage1_block(lept_stage1* s, const lept_block* b, lept_uint64* close, lept_uint64* dirty) {
+	lept_uint64 quote = b->quote & ~lept_stage1_escaped(s, b->backslash);
+	lept_uint64 in_string = lept_prefix_xor(quote) ^ s->in_string;
+	lept_uint64 structurals = (b->op & ~in_string) | quote;
+	lept_uint64 pred = structurals | b->ws;
+	lept_uint64 scalars = ((pred << 1) | s->scalar_pred) & ~b->ws & ~in_string;
+	s->in_string = (lept_uint64)0 - (in_string >> 63);
+	s->scalar_pred = pred >> 63;
+	*close = quote & ~in_string;
+	*dirty = (b->backslash | b->ctrl) & in_string;
+	return structurals | scalars;
+}
+
+#define LEPT_INDEX_DIRTY 0x80000000u  //结束引号的位置带上这一位  表示字符串中有转义或控制字符  需要逐字节解析
+
+//第一阶段找出的位置放在固定大小的窗口中  第二阶段用完之后再继续第一阶段  不需要按文本长度分配索引
+struct lept_two_stage {
+	lept_stage1 s;
+	const char* json;
+	size_t len, next;         //next 是下一个还没有处理的块的开始
+	unsigned *cur, *end;      //窗口中还没有跳过的位置   全部处理完之后最后一个位置是 len
+	unsigned index[LEPT_TWO_STAGE_WINDOW + 64 + 1];
+};
+
+static void lept_stage1_init(lept_two_stage* t, const char* json, size_t len) {
+	t->s.odd_backslash = t->s.in_string = 0;
+	t->s.scalar_pred = 1;  //文本开始相当于前面有空白
+	t->s.dirty = 0;
+	t->json = json;
+	t->len = len;
+	t->next = 0;
+	t->cur = t->end = t->index;
+}
+
+//第一阶段  继续处理后面的块  直到窗口中至少有 LEPT_TWO_STAGE_WINDOW 个位置或者到了文本结尾
+static void lept_stage1_fill(lept_two_stage* t) {
+	lept_block b;
+	lept_uint64 structurals, close, dirty, from, bit;
+	char tail[64];
+	size_t i, n = 0;
+	while (n < LEPT_TWO_STAGE_WINDOW && t->next < t->len) {
+		i = t->next;
+		if (t->len - i >= 64)
+			lept_classify(t->json + i, &b, t->s.in_string != 0);
+		else {
+			//最后不满64字节的部分用空格补齐
+			memset(tail, ' ', sizeof(tail));
+			memcpy(tail, t->json + i, t->len - i);
+			lept_classify(tail, &b, t->s.in_string != 0);
+		}
+		t->next = i + 64;
+		//长字符串的中间  整块都在字符串中  没有结构字符  也不会改变块之间传递的状态
+		if (t->s.in_string && !(b.quote | b.backslash | b.ctrl)) {
+			t->s.odd_backslash = 0;
+			continue;
+		}
+		//结束引号和开始引号之间没有别的结构字符  from 是当前字符串在这一块中的部分
+		from = ~(lept_uint64)0;
+		for (structurals = lept_stage1_block(&t->s, &b, &close, &dirty); structurals; structurals &= structurals - 1) {
+			bit = structurals & (0 - structurals);
+			t->index[n] = (unsigned)(i + lept_ctz64(structurals));
+			if (bit & close) {
+				if (t->s.dirty || (dirty & from & (bit - 1)))
+					t->index[n] |= LEPT_INDEX_DIRTY;
+			}
+			else if (bit & b.quote) {
+				from = ~(bit | (bit - 1));
+				t->s.dirty = 0;
+			}
+			n++;
+		}
+		if (t->s.in_string && (dirty & from))
+			t->s.dirty = 1;
+	}
+	if (t->next >= t->len)
+		t->index[n++] = (unsigned)t->len;
+	t->cur = t->index;
+	t->end = t->index + n;
+}
+
+//返回第一个不在 p 之前的结构字符
+static const char* lept_stage2_seek(lept_two_stage* t, const char* p) {
+	size_t pos = (size_t)(p - t->json);
+	for (;;) {
+		while (t->cur != t->end && (*t->cur & ~LEPT_INDEX_DIRTY) < pos)
+			t->cur++;
+		if (t->cur != t->end)
+			return t->json + (*t->cur & ~LEPT_INDEX_DIRTY);
+		lept_stage1_fill(t);
+	}
+}
+
+//p 是字符串开始的引号  第一阶段已经找到了结束的引号   中间没有转义和控制字符时返回结束的引号  否则返回NULL
+static const char* lept_stage2_string(lept_two_stage* t, const char* p) {
+	unsigned close;
+	if (lept_stage2_seek(t, p) != p)
+		return NULL;
+	if (++t->cur == t->end)
+		lept_stage1_fill(t);
+	close = *t->cur;
+	//没有结束引号时最后的位置是 len
+	if (close >= t->len || t->json[close] != '\"')
+		return NULL;
+	return t->json + close;
+}
+
+//空格跳过函数
+//大部分位置没有空白或只有一个空格   先用标量判断两个字符  只有遇到连续的空白(如缩进)才进入SIMD扫描
+static void lept_parse_whitespace(lept_context* c)
+{
+	const char *p = c->json, *end = c->end;
+	if (p != end && ISWHITESPACE(*p)) {
+		//两阶段解析  空白之后的第一个非空白字节一定是结构字符  直接跳到第一个在p之后的结构字符
+		if (c->stage) {
+			c->json = lept_stage2_seek(c->stage, p);
+			return;
+		}
+		p++;
+		if (p != end && ISWHITESPACE(*p))
+			p = lept_skip_whitespace(p + 1, end);
+	}
+	c->json = p;
+}
+
+
+//解析  null  true  false  的函数
+static int lept_parse_literal(lept_context* c, lept_value* v, const char* literal, lept_type type)
+{
+	size_t i;
+	EXPECT(c, literal[0]);
+
+	for (i = 0; literal[i + 1]; i++)
+	{
+		if (c->json + i == c->end || c->json[i] != literal[i + 1])
+			return LEPT_PARSE_INVALID_VALUE;
+	}
+
+	//解析成功   是null false true中的一个
+	c->json += i;//指针移动到下个值的首地址
+	v->type = type;//类型改为预期值类型
+
+	return LEPT_PARSE_OK;
+}
+
+
+//数字转换  把JSON数字文本转换成double   不再调用strtod()
+//strtod()受locale影响(小数点可能不是'.')  而且要把已经检查过语法的文本再扫描一遍
+//转换分三层  越往后越慢但适用范围越大  结果都是正确舍入的(与strtod()逐位相同)
+//1. Clinger快速路径: 有效数字不超过2^53且10的指数在[-22, 22]内时  两个操作数都能精确表示  一次乘除法即可得到正确舍入的结果
+//2. Eisel-Lemire算法: 用128位的5的幂近似值做一次(偶尔两次)64x128位乘法  直接算出尾数和指数
+//3. 大数十进制算法: 有效数字超过19位且截断后无法确定舍入方向时  用最多768位的十进制数逐步移位求出精确结果
+
+//x87浮点单元用80位精度计算中间结果  会导致两次舍入  只有在中间结果就是double精度时才能使用快速路径
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0) || defined(_M_X64) || defined(_M_ARM64) || defined(__x86_64__) || defined(__aarch64__)
+#define LEPT_CLINGER_FAST_PATH
+#endif
+
+#define LEPT_DOUBLE_EXP_INF 0x7FF                                    //无穷大的指数位
+#define LEPT_DOUBLE_INF_BITS ((lept_uint64)LEPT_DOUBLE_EXP_INF << 52) //无穷大的二进制表示(不含符号位)
+#define LEPT_DOUBLE_MANTISSA_MASK (((lept_uint64)1 << 52) - 1)
+
+#ifdef LEPT_CLINGER_FAST_PATH
+static const double lept_pow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#endif
+
+//5^q 的128位近似值(截断到最高的128位)  q 从 -342 到 324  每个q占两项: 高64位 低64位
+//解析只用到 q <= 308(更大的一定溢出成无穷大)  309到324是给浮点数生成(Grisu2)处理非规格化数用的
+#define LEPT_POW5_MIN (-342)
+#define LEPT_POW5_MAX 324
+static const lept_uint64 lept_pow5_128[] = {
+	0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL,
+	0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL,
+	0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL,
+	0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL,
+	0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL,
+	0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL,
+	0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL,
+	0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL,
+	0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL,
+	0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL,
+	0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL,
+	0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL,
+	0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL,
+	0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL,
+	0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL,
+	0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL,
+	0x84A57695FE98746DULL, 0x014BB630F7604B57ULL,
+	0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL,
+	0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL,
+	0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL,
+	0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL,
+	0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL,
+	0xFD00B897478238D0ULL, 0x8920B098955522B4ULL,
+	0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL,
+	0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL,
+	0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL,
+	0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL,
+	0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL,
+	0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL,
+	0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL,
+	0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL,
+	0xEBA09271E88D976BULL, 0xF7864A44C633682EULL,
+	0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL,
+	0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL,
+	0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL,
+	0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL,
+	0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL,
+	0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL,
+	0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL,
+	0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL,
+	0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL,
+	0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL,
+	0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL,
+	0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL,
+	0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL,
+	0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL,
+	0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL,
+	0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL,
+	0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL,
+	0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL,
+	0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL,
+	0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL,
+	0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL,
+	0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL,
+	0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL,
+	0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL,
+	0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL,
+	0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL,
+	0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL,
+	0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL,
+	0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL,
+	0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL,
+	0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL,
+	0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL,
+	0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL,
+	0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL,
+	0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL,
+	0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL,
+	0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL,
+	0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL,
+	0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL,
+	0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL,
+	0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL,
+	0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL,
+	0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL,
+	0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL,
+	0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL,
+	0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL,
+	0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL,
+	0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL,
+	0xC987434744AC874EULL, 0xA327FFB266B56220ULL,
+	0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL,
+	0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL,
+	0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL,
+	0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL,
+	0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL,
+	0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL,
+	0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL,
+	0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL,
+	0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL,
+	0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL,
+	0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL,
+	0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL,
+	0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL,
+	0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL,
+	0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL,
+	0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL,
+	0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL,
+	0xAECC49914078536DULL, 0x58FAE9F773886E18ULL,
+	0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL,
+	0x888F99797A5E012DULL, 0x6D8406C952429603ULL,
+	0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL,
+	0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL,
+	0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL,
+	0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL,
+	0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL,
+	0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL,
+	0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL,
+	0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL,
+	0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL,
+	0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL,
+	0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL,
+	0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL,
+	0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL,
+	0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL,
+	0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL,
+	0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL,
+	0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL,
+	0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL,
+	0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL,
+	0xB913179899F68584ULL, 0x28E2557B59846E3FULL,
+	0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL,
+	0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL,
+	0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL,
+	0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL,
+	0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL,
+	0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL,
+	0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL,
+	0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL,
+	0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL,
+	0xD77485CB25823AC7ULL, 0x7D633293366B828BULL,
+	0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL,
+	0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL,
+	0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL,
+	0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL,
+	0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL,
+	0xCD795BE870516656ULL, 0x67902E276C921F8BULL,
+	0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL,
+	0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL,
+	0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL,
+	0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL,
+	0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL,
+	0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL,
+	0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL,
+	0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL,
+	0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL,
+	0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL,
+	0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL,
+	0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL,
+	0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL,
+	0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL,
+	0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL,
+	0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL,
+	0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL,
+	0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL,
+	0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL,
+	0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL,
+	0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL,
+	0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL,
+	0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL,
+	0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL,
+	0xD47487CC8470652BULL, 0x7647C3200069671FULL,
+	0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL,
+	0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL,
+	0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL,
+	0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL,
+	0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL,
+	0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL,
+	0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL,
+	0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL,
+	0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL,
+	0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL,
+	0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL,
+	0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL,
+	0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL,
+	0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL,
+	0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL,
+	0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL,
+	0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL,
+	0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL,
+	0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL,
+	0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL,
+	0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL,
+	0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL,
+	0x8C974F7383725573ULL, 0x1E414218C73A13FBULL,
+	0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL,
+	0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL,
+	0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL,
+	0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL,
+	0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL,
+	0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL,
+	0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL,
+	0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL,
+	0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL,
+	0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL,
+	0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL,
+	0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL,
+	0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL,
+	0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL,
+	0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL,
+	0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL,
+	0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL,
+	0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL,
+	0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL,
+	0xBE89523386091465ULL, 0xF6BBB397F1135823ULL,
+	0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL,
+	0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL,
+	0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL,
+	0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL,
+	0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL,
+	0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL,
+	0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL,
+	0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL,
+	0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL,
+	0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL,
+	0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL,
+	0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL,
+	0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL,
+	0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL,
+	0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL,
+	0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL,
+	0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL,
+	0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL,
+	0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL,
+	0x811CCC668829B887ULL, 0x0806357D5A3F525FULL,
+	0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL,
+	0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL,
+	0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL,
+	0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL,
+	0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL,
+	0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL,
+	0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL,
+	0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL,
+	0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL,
+	0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL,
+	0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL,
+	0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL,
+	0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL,
+	0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL,
+	0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL,
+	0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL,
+	0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL,
+	0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL,
+	0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL,
+	0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL,
+	0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL,
+	0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL,
+	0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL,
+	0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL,
+	0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL,
+	0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL,
+	0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL,
+	0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL,
+	0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL,
+	0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL,
+	0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL,
+	0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL,
+	0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL,
+	0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL,
+	0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL,
+	0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL,
+	0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL,
+	0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL,
+	0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL,
+	0xED246723473E3813ULL, 0x290123E9AAB23B68ULL,
+	0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL,
+	0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL,
+	0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL,
+	0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL,
+	0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL,
+	0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL,
+	0x8D590723948A535FULL, 0x579C487E5A38AD0EULL,
+	0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL,
+	0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL,
+	0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL,
+	0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL,
+	0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL,
+	0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL,
+	0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL,
+	0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL,
+	0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL,
+	0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL,
+	0xCDB02555653131B6ULL, 0x3792F412CB06794DULL,
+	0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL,
+	0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL,
+	0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL,
+	0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL,
+	0x9CED737BB6C4183DULL, 0x55464DD69685606BULL,
+	0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL,
+	0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL,
+	0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL,
+	0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL,
+	0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL,
+	0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL,
+	0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL,
+	0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL,
+	0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL,
+	0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL,
+	0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL,
+	0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL,
+	0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL,
+	0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL,
+	0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL,
+	0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL,
+	0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL,
+	0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL,
+	0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL,
+	0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL,
+	0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL,
+	0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL,
+	0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL,
+	0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL,
+	0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL,
+	0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL,
+	0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL,
+	0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL,
+	0xC612062576589DDAULL, 0x95364AFE032A819EULL,
+	0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL,
+	0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL,
+	0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL,
+	0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL,
+	0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL,
+	0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL,
+	0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL,
+	0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL,
+	0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL,
+	0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL,
+	0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL,
+	0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL,
+	0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL,
+	0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL,
+	0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL,
+	0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL,
+	0x89705F4136B4A597ULL, 0x31680A88F8953031ULL,
+	0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL,
+	0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL,
+	0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL,
+	0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL,
+	0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL,
+	0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL,
+	0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL,
+	0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL,
+	0x8000000000000000ULL, 0x0000000000000000ULL,
+	0xA000000000000000ULL, 0x0000000000000000ULL,
+	0xC800000000000000ULL, 0x0000000000000000ULL,
+	0xFA00000000000000ULL, 0x0000000000000000ULL,
+	0x9C40000000000000ULL, 0x0000000000000000ULL,
+	0xC350000000000000ULL, 0x0000000000000000ULL,
+	0xF424000000000000ULL, 0x0000000000000000ULL,
+	0x9896800000000000ULL, 0x0000000000000000ULL,
+	0xBEBC200000000000ULL, 0x0000000000000000ULL,
+	0xEE6B280000000000ULL, 0x0000000000000000ULL,
+	0x9502F90000000000ULL, 0x0000000000000000ULL,
+	0xBA43B74000000000ULL, 0x0000000000000000ULL,
+	0xE8D4A51000000000ULL, 0x0000000000000000ULL,
+	0x9184E72A00000000ULL, 0x0000000000000000ULL,
+	0xB5E620F480000000ULL, 0x0000000000000000ULL,
+	0xE35FA931A0000000ULL, 0x0000000000000000ULL,
+	0x8E1BC9BF04000000ULL, 0x0000000000000000ULL,
+	0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL,
+	0xDE0B6B3A76400000ULL, 0x0000000000000000ULL,
+	0x8AC7230489E80000ULL, 0x0000000000000000ULL,
+	0xAD78EBC5AC620000ULL, 0x0000000000000000ULL,
+	0xD8D726B7177A8000ULL, 0x0000000000000000ULL,
+	0x878678326EAC9000ULL, 0x0000000000000000ULL,
+	0xA968163F0A57B400ULL, 0x0000000000000000ULL,
+	0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL,
+	0x84595161401484A0ULL, 0x0000000000000000ULL,
+	0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL,
+	0xCECB8F27F4200F3AULL, 0x0000000000000000ULL,
+	0x813F3978F8940984ULL, 0x4000000000000000ULL,
+	0xA18F07D736B90BE5ULL, 0x5000000000000000ULL,
+	0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL,
+	0xFC6F7C4045812296ULL, 0x4D00000000000000ULL,
+	0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL,
+	0xC5371912364CE305ULL, 0x6C28000000000000ULL,
+	0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL,
+	0x9A130B963A6C115CULL, 0x3C7F400000000000ULL,
+	0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL,
+	0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL,
+	0x96769950B50D88F4ULL, 0x1314448000000000ULL,
+	0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL,
+	0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL,
+	0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL,
+	0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL,
+	0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL,
+	0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL,
+	0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL,
+	0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL,
+	0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL,
+	0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL,
+	0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL,
+	0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL,
+	0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL,
+	0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL,
+	0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL,
+	0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL,
+	0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL,
+	0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL,
+	0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL,
+	0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL,
+	0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL,
+	0x9F4F2726179A2245ULL, 0x01D762422C946590ULL,
+	0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL,
+	0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL,
+	0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL,
+	0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL,
+	0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL,
+	0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL,
+	0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL,
+	0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL,
+	0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL,
+	0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL,
+	0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL,
+	0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL,
+	0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL,
+	0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL,
+	0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL,
+	0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL,
+	0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL,
+	0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL,
+	0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL,
+	0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL,
+	0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL,
+	0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL,
+	0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL,
+	0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL,
+	0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL,
+	0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL,
+	0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL,
+	0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL,
+	0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL,
+	0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL,
+	0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL,
+	0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL,
+	0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL,
+	0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL,
+	0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL,
+	0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL,
+	0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL,
+	0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL,
+	0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL,
+	0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL,
+	0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL,
+	0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL,
+	0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL,
+	0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL,
+	0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL,
+	0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL,
+	0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL,
+	0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL,
+	0x884134FE908658B2ULL, 0x3109058D147FDCDDULL,
+	0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL,
+	0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL,
+	0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL,
+	0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL,
+	0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL,
+	0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL,
+	0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL,
+	0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL,
+	0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL,
+	0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL,
+	0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL,
+	0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL,
+	0x9AE757596946075FULL, 0x3375788DE9B06958ULL,
+	0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL,
+	0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL,
+	0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL,
+	0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL,
+	0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL,
+	0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL,
+	0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL,
+	0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL,
+	0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL,
+	0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL,
+	0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL,
+	0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL,
+	0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL,
+	0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL,
+	0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL,
+	0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL,
+	0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL,
+	0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL,
+	0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL,
+	0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL,
+	0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL,
+	0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL,
+	0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL,
+	0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL,
+	0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL,
+	0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL,
+	0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL,
+	0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL,
+	0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL,
+	0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL,
+	0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL,
+	0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL,
+	0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL,
+	0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL,
+	0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL,
+	0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL,
+	0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL,
+	0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL,
+	0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL,
+	0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL,
+	0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL,
+	0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL,
+	0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL,
+	0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL,
+	0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL,
+	0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL,
+	0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL,
+	0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL,
+	0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL,
+	0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL,
+	0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL,
+	0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL,
+	0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL,
+	0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL,
+	0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL,
+	0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL,
+	0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL,
+	0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL,
+	0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL,
+	0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL,
+	0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL,
+	0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL,
+	0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL,
+	0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL,
+	0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL,
+	0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL,
+	0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL,
+	0x8FA475791A569D10ULL, 0xF96E017D694487BCULL,
+	0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL,
+	0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL,
+	0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL,
+	0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL,
+	0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL,
+	0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL,
+	0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL,
+	0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL,
+	0x85C7056562757456ULL, 0xF6872D5667844E49ULL,
+	0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL,
+	0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL,
+	0x82A45B450226B39CULL, 0xECC0024661173473ULL,
+	0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL,
+	0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL,
+	0xFF290242C83396CEULL, 0x7E67047175A15271ULL,
+	0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL,
+	0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL,
+	0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL,
+	0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL,
+	0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL,
+	0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL,
+	0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL,
+	0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL,
+	0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL,
+	0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL,
+	0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL,
+	0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL,
+	0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL,
+	0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL,
+	0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL,
+	0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL,
+	0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL,
+	0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL,
+	0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL,
+	0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL,
+	0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL,
+	0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL,
+	0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL,
+	0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL,
+	0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL,
+	0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL,
+	0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL,
+	0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL,
+	0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL,
+	0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL,
+	0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL,
+	0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL,
+	0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL,
+	0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL,
+	0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL,
+	0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL,
+	0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL,
+	0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL,
+	0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL,
+	0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL,
+	0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL,
+	0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL,
+	0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL,
+	0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL,
+	0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL,
+	0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL,
+	0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL,
+	0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL,
+	0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL,
+	0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL,
+	0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL,
+	0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL,
+	0x8533285C936B35DEULL, 0xD53A88958F87275FULL,
+	0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL,
+	0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL,
+	0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL,
+	0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL,
+	0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL,
+	0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL,
+	0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL,
+	0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL,
+	0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL,
+	0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL,
+	0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL,
+	0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL,
+	0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL,
+	0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL,
+	0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL,
+	0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL,
+	0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL,
+	0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL,
+	0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL,
+	0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL,
+	0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL,
+	0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL,
+	0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL,
+	0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL,
+	0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL,
+	0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL,
+	0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL,
+	0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL,
+	0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL,
+	0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL,
+	0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL,
+	0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL,
+	0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL,
+	0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL,
+	0xA0555E361951C366ULL, 0xD7E105BCC332621FULL,
+	0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL,
+	0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL,
+	0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL,
+	0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL,
+	0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL,
+	0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL,
+	0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL,
+	0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL,
+	0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL,
+	0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL,
+	0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL,
+	0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL,
+	0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL,
+	0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL,
+	0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL,
+	0xB201833B35D63F73ULL, 0x2CD2CC6551E513DAULL,
+	0xDE81E40A034BCF4FULL, 0xF8077F7EA65E58D1ULL,
+	0x8B112E86420F6191ULL, 0xFB04AFAF27FAF782ULL,
+	0xADD57A27D29339F6ULL, 0x79C5DB9AF1F9B563ULL,
+	0xD94AD8B1C7380874ULL, 0x18375281AE7822BCULL,
+	0x87CEC76F1C830548ULL, 0x8F2293910D0B15B5ULL,
+	0xA9C2794AE3A3C69AULL, 0xB2EB3875504DDB22ULL,
+	0xD433179D9C8CB841ULL, 0x5FA60692A46151EBULL,
+	0x849FEEC281D7F328ULL, 0xDBC7C41BA6BCD333ULL,
+	0xA5C7EA73224DEFF3ULL, 0x12B9B522906C0800ULL,
+	0xCF39E50FEAE16BEFULL, 0xD768226B34870A00ULL,
+	0x81842F29F2CCE375ULL, 0xE6A1158300D46640ULL,
+	0xA1E53AF46F801C53ULL, 0x60495AE3C1097FD0ULL,
+	0xCA5E89B18B602368ULL, 0x385BB19CB14BDFC4ULL,
+	0xFCF62C1DEE382C42ULL, 0x46729E03DD9ED7B5ULL,
+	0x9E19DB92B4E31BA9ULL, 0x6C07A2C26A8346D1ULL
+};
+
+//64位乘64位  返回积的低64位  高64位写入hi
+static lept_uint64 lept_umul128(lept_uint64 a, lept_uint64 b, lept_uint64* hi) {
+#if defined(__SIZEOF_INT128__)
+	__extension__ unsigned __int128 r = (unsigned __int128)a * b;
+	*hi = (lept_uint64)(r >> 64);
+	return (lept_uint64)r;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return _umul128(a, b, hi);
+#else
+	//拆成32位的四个部分积
+	lept_uint64 a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+	lept_uint64 ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+	lept_uint64 mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+	*hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	return (mid << 32) | (ll & 0xFFFFFFFF);
+#endif
+}
+
+//返回最高位的1前面0的个数  x 不能为0
+static int lept_clz64(lept_uint64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanReverse64(&i, x);
+	return 63 - (int)i;
+#else
+	int n = 0;
+	while (!(x & ((lept_uint64)1 << 63))) { x <<= 1; n++; }
+	return n;
+#endif
+}
+
+//Eisel-Lemire算法  求 w * 10^q 最接近的double  w 不能为0
+//成功返回1  bits 写入double的二进制表示(不含符号位)   乘积的误差可能影响舍入时返回0  交给大数算法
+static int lept_eisel_lemire(lept_uint64 w, int q, lept_uint64* bits) {
+	const lept_uint64* pow5;
+	lept_uint64 lo, hi, hi2, mantissa;
+	int lz, upperbit, shift, power2;
+
+	if (q < LEPT_POW5_MIN) { *bits = 0; return 1; }
+	if (q > 308) { *bits = LEPT_DOUBLE_INF_BITS; return 1; }  //w >= 1  所以一定大于DBL_MAX
+
+	//规格化w  使最高位为1
+	lz = lept_clz64(w);
+	w <<= lz;
+	pow5 = lept_pow5_128 + 2 * (q - LEPT_POW5_MIN);
+	lo = lept_umul128(w, pow5[0], &hi);
+	//只需要积的高55位(52位尾数+隐含位+1位舍入+1位可能的进位)
+	//这些位以下全是1时  低64位的误差可能进位上来  再乘上5^q的低64位修正
+	if ((hi & 0x1FF) == 0x1FF) {
+		lept_umul128(w, pow5[1], &hi2);
+		lo += hi2;
+		if (hi2 > lo)
+			hi++;
+	}
+	if (lo == ~(lept_uint64)0 && (q < -27 || q > 55))
+		return 0;
+
+	upperbit = (int)(hi >> 63);
+	shift = upperbit + 64 - 52 - 3;
+	mantissa = hi >> shift;
+	//(217706 * q) >> 16 等于 floor(q * log2(10))
+	power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+
+	if (power2 <= 0) {
+		//非规格化数
+		if (-power2 + 1 >= 64) {
+			*bits = 0;
+			return 1;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		//舍入后可能刚好进位成最小的规格化数
+		power2 = mantissa < ((lept_uint64)1 << 52) ? 0 : 1;
+		*bits = (mantissa & LEPT_DOUBLE_MANTISSA_MASK) | ((lept_uint64)power2 << 52);
+		return 1;
+	}
+
+	//恰好落在两个double正中间时要舍入到偶数  而不是总是向上舍入
+	//只有5^q能放进64位时(q在[-4, 23]内)才可能出现这种情况
+	if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == hi)
+		mantissa &= ~(lept_uint64)1;
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= ((lept_uint64)2 << 52)) {
+		mantissa = (lept_uint64)1 << 52;
+		power2++;
+	}
+	if (power2 >= LEPT_DOUBLE_EXP_INF) {
+		*bits = LEPT_DOUBLE_INF_BITS;
+		return 1;
+	}
+	*bits = (mantissa & LEPT_DOUBLE_MANTISSA_MASK) | ((lept_uint64)power2 << 52);
+	return 1;
+}
+
+//大数十进制算法用的十进制数  值为 0.d1d2d3... * 10^decimal_point
+//double的精确十进制展开最多有767位有效数字  所以768位足够判断舍入
+#define LEPT_DECIMAL_MAX_DIGITS 768
+#define LEPT_DECIMAL_POINT_RANGE 2047
+
+typedef struct {
+	unsigned num_digits;
+	int decimal_point;
+	int truncated;  //超出768位的部分是否有非0数字
+	unsigned char digits[LEPT_DECIMAL_MAX_DIGITS];
+}lept_decimal;
+
+//从已经检查过语法的数字文本[p, end)读出十进制数  忽略前导和末尾的0
+static void lept_decimal_parse(lept_decimal* d, const char* p, const char* end) {
+	const char* last;
+	int e, eneg;
+
+	d->num_digits = 0;
+	d->decimal_point = 0;
+	d->truncated = 0;
+	if (*p == '-')
+		p++;
+	while (p != end && *p == '0')
+		p++;
+	for (; p != end && ISDIGIT(*p); p++) {
+		if (d->num_digits < LEPT_DECIMAL_MAX_DIGITS)
+			d->digits[d->num_digits] = (unsigned char)(*p - '0');
+		d->num_digits++;
+	}
+	d->decimal_point = (int)d->num_digits;
+	if (p != end && *p == '.') {
+		p++;
+		if (d->num_digits == 0)
+			for (; p != end && *p == '0'; p++)
+				d->decimal_point--;
+		for (; p != end && ISDIGIT(*p); p++) {
+			if (d->num_digits < LEPT_DECIMAL_MAX_DIGITS)
+				d->digits[d->num_digits] = (unsigned char)(*p - '0');
+			d->num_digits++;
+		}
+	}
+	//去掉末尾的0  这样num_digits就是真正的有效数字个数  truncated 才准确
+	if (d->num_digits > 0) {
+		for (last = p - 1; *last == '0' || *last == '.'; last--)
+			if (*last == '0')
+				d->num_digits--;
+	}
+	if (d->num_digits > LEPT_DECIMAL_MAX_DIGITS) {
+		d->truncated = 1;
+		d->num_digits = LEPT_DECIMAL_MAX_DIGITS;
+	}
+	if (p != end && (*p == 'e' || *p == 'E')) {
+		p++;
+		eneg = *p == '-';
+		if (*p == '+' || *p == '-')
+			p++;
+		for (e = 0; p != end && ISDIGIT(*p); p++)
+			if (e < 0x10000)
+				e = e * 10 + (*p - '0');
+		d->decimal_point += eneg ? -e : e;
+	}
+}
+
+static void lept_decimal_trim(lept_decimal* d) {
+	while (d->num_digits > 0 && d->digits[d->num_digits - 1] == 0)
+		d->num_digits--;
+}
+
+//计算 d * 2^shift   shift 不超过60  先把结果从低位写进临时缓冲区  再复制回来
+static void lept_decimal_left_shift(lept_decimal* d, unsigned shift) {
+	unsigned char buf[LEPT_DECIMAL_MAX_DIGITS + 20];
+	size_t w = sizeof(buf);
+	unsigned r = d->num_digits, count, i;
+	lept_uint64 n = 0;
+
+	if (d->num_digits == 0)
+		return;
+	while (r > 0) {
+		n += (lept_uint64)d->digits[--r] << shift;
+		buf[--w] = (unsigned char)(n % 10);
+		n /= 10;
+	}
+	while (n > 0) {
+		buf[--w] = (unsigned char)(n % 10);
+		n /= 10;
+	}
+	count = (unsigned)(sizeof(buf) - w);
+	d->decimal_point += (int)(count - d->num_digits);
+	if (count > LEPT_DECIMAL_MAX_DIGITS) {
+		for (i = LEPT_DECIMAL_MAX_DIGITS; i < count; i++)
+			if (buf[w + i] != 0)
+				d->truncated = 1;
+		count = LEPT_DECIMAL_MAX_DIGITS;
+	}
+	memcpy(d->digits, buf + w, count);
+	d->num_digits = count;
+	lept_decimal_trim(d);
+}
+
+//计算 d / 2^shift   shift 不超过60
+static void lept_decimal_right_shift(lept_decimal* d, unsigned shift) {
+	unsigned r = 0, w = 0;
+	lept_uint64 n = 0, mask = ((lept_uint64)1 << shift) - 1;
+	unsigned char digit;
+
+	//先读入足够多的数字  使第一位商不为0
+	while ((n >> shift) == 0) {
+		if (r < d->num_digits)
+			n = 10 * n + d->digits[r++];
+		else if (n == 0)
+			return;
+		else {
+			while ((n >> shift) == 0) {
+				n = 10 * n;
+				r++;
+			}
+			break;
+		}
+	}
+	d->decimal_point -= (int)r - 1;
+	if (d->decimal_point < -LEPT_DECIMAL_POINT_RANGE) {
+		d->num_digits = 0;
+		d->decimal_point = 0;
+		d->truncated = 0;
+		return;
+	}
+	while (r < d->num_digits) {
+		digit = (unsigned char)(n >> shift);
+		n = 10 * (n & mask) + d->digits[r++];
+		d->digits[w++] = digit;
+	}
+	while (n > 0) {
+		digit = (unsigned char)(n >> shift);
+		n = 10 * (n & mask);
+		if (w < LEPT_DECIMAL_MAX_DIGITS)
+			d->digits[w++] = digit;
+		else if (digit > 0)
+			d->truncated = 1;
+	}
+	d->num_digits = w;
+	lept_decimal_trim(d);
+}
+
+//取整数部分并正确舍入(恰好一半时舍入到偶数)
+static lept_uint64 lept_decimal_round(const lept_decimal* d) {
+	unsigned i, dp;
+	lept_uint64 n = 0;
+	int round_up = 0;
+
+	if (d->num_digits == 0 || d->decimal_point < 0)
+		return 0;
+	if (d->decimal_point > 18)
+		return ~(lept_uint64)0;
+	dp = (unsigned)d->decimal_point;
+	for (i = 0; i < dp; i++)
+		n = 10 * n + (i < d->num_digits ? d->digits[i] : 0);
+	if (dp < d->num_digits) {
+		round_up = d->digits[dp] >= 5;
+		if (d->digits[dp] == 5 && dp + 1 == d->num_digits)
+			round_up = d->truncated || (dp > 0 && (d->digits[dp - 1] & 1));
+	}
+	return n + (round_up ? 1 : 0);
+}
+
+//大数十进制算法  先把数字移位到[1/2, 1)之间并记下2的指数  再左移53位取整得到尾数
+//返回double的二进制表示(不含符号位)
+static lept_uint64 lept_decimal_to_double(const char* json, const char* end) {
+	static const unsigned char powers[] = {
+		0, 3, 6, 9, 13, 16, 19, 23, 26, 29, 33, 36, 39, 43, 46, 49, 53, 56, 59
+	};  //powers[n]: 2^powers[n] <= 10^n 的最大值  用于每次尽量多地移位
+	lept_decimal d;
+	lept_uint64 mantissa;
+	unsigned shift, n;
+	int exp2 = 0;
+
+	lept_decimal_parse(&d, json, end);
+	if (d.num_digits == 0 || d.decimal_point < -324)
+		return 0;
+	if (d.decimal_point >= 310)
+		return LEPT_DOUBLE_INF_BITS;
+
+	while (d.decimal_point > 0) {
+		n = (unsigned)d.decimal_point;
+		shift = n < sizeof(powers) ? powers[n] : 60;
+		lept_decimal_right_shift(&d, shift);
+		if (d.decimal_point < -LEPT_DECIMAL_POINT_RANGE)
+			return 0;
+		exp2 += (int)shift;
+	}
+	while (d.decimal_point <= 0) {
+		if (d.decimal_point == 0) {
+			if (d.digits[0] >= 5)
+				break;
+			shift = d.digits[0] < 2 ? 2 : 1;
+		}
+		else {
+			n = (unsigned)-d.decimal_point;
+			shift = n < sizeof(powers) ? powers[n] : 60;
+		}
+		lept_decimal_left_shift(&d, shift);
+		if (d.decimal_point > LEPT_DECIMAL_POINT_RANGE)
+			return LEPT_DOUBLE_INF_BITS;
+		exp2 -= (int)shift;
+	}
+	//现在在[1/2, 1)之间  而double的尾数在[1, 2)之间
+	exp2--;
+	while (exp2 < -1022) {
+		n = (unsigned)(-1022 - exp2);
+		if (n > 60)
+			n = 60;
+		lept_decimal_right_shift(&d, n);
+		exp2 += (int)n;
+	}
+	if (exp2 + 1023 >= LEPT_DOUBLE_EXP_INF)
+		return LEPT_DOUBLE_INF_BITS;
+
+	lept_decimal_left_shift(&d, 53);
+	mantissa = lept_decimal_round(&d);
+	//舍入可能进位到第54位  需要右移一位
+	if (mantissa >= ((lept_uint64)1 << 53)) {
+		lept_decimal_right_shift(&d, 1);
+		exp2++;
+		mantissa = lept_decimal_round(&d);
+		if (exp2 + 1023 >= LEPT_DOUBLE_EXP_INF)
+			return LEPT_DOUBLE_INF_BITS;
+	}
+	//没有隐含位的是非规格化数  指数位为0
+	return (mantissa & LEPT_DOUBLE_MANTISSA_MASK) |
+		((lept_uint64)(mantissa < ((lept_uint64)1 << 52) ? exp2 + 1022 : exp2 + 1023) << 52);
+}
+
+//把数字转换为double   [json, end) 是已经检查过语法的数字文本   w 是前19位有效数字  值约为 w * 10^q
+//truncated 表示19位之后还有非0的数字被截掉了
+static int lept_number_to_double(const char* json, const char* end, int negative, lept_uint64 w, int q, int truncated, double* d) {
+	lept_uint64 bits, bits2;
+
+	if (w == 0)
+		bits = 0;
+	else {
+#ifdef LEPT_CLINGER_FAST_PATH
+		if (!truncated && q >= -22 && q <= 22 && w <= ((lept_uint64)1 << 53)) {
+			double x = (double)w;
+			x = q < 0 ? x / lept_pow10[-q] : x * lept_pow10[q];
+			*d = negative ? -x : x;
+			return LEPT_PARSE_OK;
+		}
+#endif
+		//被截断时真实值在 w 和 w+1 之间  两者结果相同才能确定
+		if (!lept_eisel_lemire(w, q, &bits) ||
+			(truncated && (!lept_eisel_lemire(w + 1, q, &bits2) || bits != bits2)))
+			bits = lept_decimal_to_double(json, end);
+	}
+	if (bits == LEPT_DOUBLE_INF_BITS)
+		return LEPT_PARSE_NUMBER_TOO_BIG;
+	if (negative)
+		bits |= (lept_uint64)1 << 63;
+	memcpy(d, &bits, sizeof(double));
+	return LEPT_PARSE_OK;
+}
+
+//解析number
+static int lept_parse_number(lept_context* c, lept_value* v) {
+
+	/*   JOSN number类型
+	number = [ "-" ] int [ frac ] [ exp ]
+	int = "0" / digit1-9 *digit
+	frac = "." 1*digit
+	exp = ("e" / "E") ["-" / "+"] 1*digit
+	*/
+
+	//检查语法的同时累积前19位有效数字(64位整数放得下)   值约为 w * 10^exp10
+	//每次读取前都要检查是否到达文本结尾
+	const char *p = c->json, *end = c->end;
+	lept_uint64 w = 0;
+	int ndigits = 0, exp10 = 0, truncated = 0, negative = 0, integer = 1, ret;
+
+	if (*p == '-') {
+		negative = 1;
+		p++;
+	}
+	if (p != end && *p == '0') p++;
+	else {
+		//符号后不能只有0
+		if (p == end || !ISDIGIT1TO9(*p))
+			return LEPT_PARSE_INVALID_VALUE;
+
+		for (; p != end && ISDIGIT(*p); p++) {
+			if (ndigits < 19) {
+				w = w * 10 + (unsigned)(*p - '0');
+				ndigits++;
+			}
+			else {
+				exp10++;
+				truncated |= *p != '0';
+			}
+		}
+	}
+	//没有小数和指数部分的数字是整数字面值
+	//整数部分刚好20位时第20位被当作截断的数字  在这里补回来  看能否放进无符号64位整数
+	if (p == end || (*p != '.' && *p != 'e' && *p != 'E')) {
+		if (exp10 == 1 && w <= (~(lept_uint64)0 - (unsigned)(p[-1] - '0')) / 10) {
+			w = w * 10 + (unsigned)(p[-1] - '0');
+			exp10 = 0;
+		}
+		integer = exp10 == 0;
+	}
+	else
+		integer = 0;
+
+	if (p != end && *p == '.') {
+		p++;
+		//点后边没数
+		if (p == end || !ISDIGIT(*p))
+			return LEPT_PARSE_INVALID_VALUE;
+
+		for (; p != end && ISDIGIT(*p); p++) {
+			if (ndigits < 19) {
+				//小数点后的前导0不占有效数字的位置
+				if (w != 0 || *p != '0') {
+					w = w * 10 + (unsigned)(*p - '0');
+					ndigits++;
+				}
+				exp10--;
+			}
+			else
+				truncated |= *p != '0';
+		}
+	}
+	if (p != end && (*p == 'e' || *p == 'E')) {
+		int e = 0, eneg = 0;
+		p++;
+		if (p != end && (*p == '+' || *p == '-'))
+			eneg = *p++ == '-';
+		if (p == end || !ISDIGIT(*p)) return LEPT_PARSE_INVALID_VALUE;
+		//指数超过100000时结果一定是0或者溢出  不再累加  防止int溢出
+		for (; p != end && ISDIGIT(*p); p++)
+			if (e < 100000)
+				e = e * 10 + (*p - '0');
+		exp10 += eneg ? -e : e;
+	}
+
+	//整数字面值能放进64位时按整数存储  不经过double  也不会丢失精度
+	//"-0" 按double存储  才能保留负号
+	if (integer && !negative && w <= (lept_uint64)LEPT_INT64_MAX) {
+		v->u.i64 = (lept_int64)w;
+		v->flags = LEPT_FLAG_INT64;
+	}
+	else if (integer && !negative) {
+		v->u.u64 = w;
+		v->flags = LEPT_FLAG_UINT64;
+	}
+	else if (integer && w != 0 && w <= (lept_uint64)LEPT_INT64_MAX + 1) {
+		v->u.i64 = w == (lept_uint64)LEPT_INT64_MAX + 1 ? LEPT_INT64_MIN : -(lept_int64)w;
+		v->flags = LEPT_FLAG_INT64;
+	}
+	//解析number成功  转换成double   超出double的范围时返回数字过大
+	else if ((ret = lept_number_to_double(c->json, p, negative, w, exp10, truncated, &v->u.n)) != LEPT_PARSE_OK)
+		return ret;
+
+	//数据类型变  指针位置变
+	v->type = LEPT_NUMBER;
+	c->json = p;
+
+	return LEPT_PARSE_OK;
+}
+
+//检验  /u后是否时4位有效数字   传入json 文本结尾 和一个存放解析成功转化的十进制数
+static const char* lept_parse_hex4(const char* p, const char* end, unsigned* u) {
+	int i;
+	*u = 0;
+	if (end - p < 4)
+		return NULL;
+	for (i = 0; i < 4; i++) {
+
+		char ch = *p++;
+
+		*u <<= 4;//每次将数扩大2的4次方  相当于解析对应十六进制的一个字符
+
+		//将每个字符转化位对应的十进制数
+		if (ch >= '0' && ch <= '9')  *u |= ch - '0';
+		else if (ch >= 'A' && ch <= 'F')  *u |= ch - ('A' - 10);
+		else if (ch >= 'a' && ch <= 'f')  *u |= ch - ('a' - 10);
+
+		//字符无效转化失败
+		else return NULL;
+	}
+	//解析成功
+	return p;
+}
+
+//解析UTF-8编码格式  传入输出位置 和 解析Unicode所得的十进制数  返回写入的字节数(1~4)
+static size_t lept_encode_utf8(char* buf, unsigned u) {
+	//char，为什么要做 x & 0xFF 这种操作呢？
+	//这是因为 u 是 unsigned 类型，
+	//一些编译器可能会警告这个转型可能会截断数据。
+	//但实际上，配合了范围的检测然后右移之后，
+	//可以保证写入的是 0~255 内的值。
+	//为了避免一些编译器的警告误判，
+	//我们加上 u & 0xFF
+
+
+	//码点范围：U+0000-U+007F	 码点位数：7	  字节1：0xxxxxxx	
+	if (u <= 0x7F) {
+		buf[0] = u & 0xFF;
+		return 1;
+	}
+
+	//码点范围：U+0080 ~ U+07FF	   码点位数：11	    字节1：110xxxxx 字节2：10xxxxxx	
+	else if (u <= 0x7FF) {
+		buf[0] = 0xC0 | ((u >> 6) & 0xFF);
+		buf[1] = 0x80 | (u & 0x3F);
+		return 2;
+	}
+
+	//码点范围：U+0800 ~ U+FFFF	 码点位数：16	  字节1：110xxxxx 字节2：10xxxxxx  字节3：10xxxxxx
+	else if (u <= 0xFFFF) {
+		buf[0] = 0xE0 | ((u >> 12) & 0xFF);
+		buf[1] = 0x80 | ((u >> 6) & 0x3F);
+		buf[2] = 0x80 | (u & 0x3F);
+		return 3;
+	}
+
+	//码点范围：U+10000 ~ U+10FFFF	 码点位数：21	  字节1：11110xxx  字节2：10xxxxxx  字节3：10xxxxxx	 字节4：10xxxxxx
+	else {
+		assert(u <= 0x10FFFF);
+		buf[0] = 0xF0 | ((u >> 18) & 0xFF);
+		buf[1] = 0x80 | ((u >> 12) & 0x3F);
+		buf[2] = 0x80 | ((u >> 6) & 0x3F);
+		buf[3] = 0x80 | (u & 0x3F);
+		return 4;
+	}
+}
+
+//传入解析结果   更新top直接跳过此字符   重构返回错误吗的处理抽取为宏
+#define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
+
+//解码后的字符写入栈  原地解析时写回缓冲区  解码后总是不比原文长  所以 dst 不会超过 p
+#define STRING_PUTS(s, n) do { if (dst) { memmove(dst, s, n); dst += (n); } else PUTS(c, s, n); } while(0)
+#define STRING_PUTC(ch)   do { if (dst) *dst++ = (ch); else PUTC(c, ch); } while(0)
+
+//解析 JSON 字符串，把结果写入 str 和 len  str 指向 c->stack 中的元素，需要在 c->stack
+//这样的话，我们实现对象的解析时，就可以使用 lept_parse_string_raw()　来解析 JSON 字符串，然后把结果复制至 lept_member 的 k 和 klen 字段。
+//原地解析时 str 指向缓冲区中字符串原来的位置  结尾的引号(或者它前面的位置)被改写成'\0'
+static int lept_parse_string_raw(lept_context* c, char** str, size_t* len) {
+
+	size_t head = c->top;//标记此时还没push栈的top   用于解析过程中失败从而还原top值
+	unsigned u, u2;
+	const char* p;
+	char *start, *dst;
+	char buf[4];
+	size_t n;
+
+	//两阶段解析时大部分字符串不用再扫描  直接指向文本  调用者会复制
+	if (c->stage && (p = lept_stage2_string(c->stage, c->json)) != NULL) {
+		*str = (char*)c->json + 1;
+		*len = (size_t)(p - c->json - 1);
+		c->json = p + 1;
+		return LEPT_PARSE_OK;
+	}
+
+	EXPECT(c, '\"');//跳过 "
+	p = c->json;
+	start = dst = c->insitu ? (char*)p : NULL;
+
+	for (;;) {
+		char ch;
+
+		//先找出下一个需要特殊处理的字符  中间的普通字符一次性复制进栈  不再逐个PUTC
+		//原地解析时还没有遇到转义之前 dst 和 p 相同  不需要移动
+		//引号  反斜线  控制字符都是ASCII字符  不会出现在多字节字符中间  每一段可以单独校验
+		const char* q = c->validate_utf8 ? lept_scan_utf8(p, c->end) : lept_scan_string(p, c->end);
+		if (q == NULL)
+			STRING_ERROR(LEPT_PARSE_INVALID_UTF8);
+		if (q != p) {
+			if (dst != p)
+				STRING_PUTS(p, (size_t)(q - p));
+			else
+				dst = (char*)q;
+			p = q;
+		}
+
+		//到了文本结尾还没有遇到引号
+		if (p == c->end)
+			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
+		ch = *p++;
+		switch (ch) {
+
+			//表示字符串的结束
+		case '\"':
+			if (dst) {
+				*dst = '\0';
+				*len = (size_t)(dst - start);
+				*str = start;
+			}
+			else {
+				*len = c->top - head;//字符串的长度
+				*str = lept_context_pop(c, *len);//出栈后的头指针
+			}
+			c->json = p;//移动文本指针
+			return LEPT_PARSE_OK;//成功
+
+		//转移字符
+		case '\\':
+			//反斜线在结尾时按无效的转义处理
+			switch (p != c->end ? *p++ : '\0') {
+			case '\"': STRING_PUTC('\"'); break;
+			case '\\': STRING_PUTC('\\'); break;
+			case '/':  STRING_PUTC('/'); break;
+			case 'b':  STRING_PUTC('\b'); break;
+			case 'f':  STRING_PUTC('\f'); break;
+			case 'n':  STRING_PUTC('\n'); break;
+			case 'r':  STRING_PUTC('\r'); break;
+			case 't':  STRING_PUTC('\t'); break;
+
+				//Unicode码转十进制再转UTF-8编码格式
+			case 'u':
+
+				//先将十六进制转化位十进制数存入u中
+				if (!(p = lept_parse_hex4(p, c->end, &u)))
+					STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
+
+				//U+0000 至 U+FFFF 这组 Unicode 字符称为基本多文种平面（basic multilingual plane, BMP），
+				//还有另外 16 个平面。
+				//那么 BMP 以外的字符，JSON 会使用代理对（surrogate pair）表示 \uXXXX\uYYYY。
+				//在 BMP 中，保留了 2048 个代理码点。
+
+				//如果第一个码点是U+D800 至 U+DBFF  它的代码对的高代理项 （high surrogate）
+				if (u >= 0xD800 && u <= 0xDBFF) { /* surrogate pair */
+
+					//之后应该伴随一个 U+DC00 至 U+DFFF 的低代理项（low surrogate）
+					if (c->end - p < 2 || p[0] != '\\' || p[1] != 'u')
+						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+					p += 2;
+
+					//再次解析一个 \u后是否是4位十六进位数字
+					if (!(p = lept_parse_hex4(p, c->end, &u2)))
+						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
+
+					//U+DC00 至 U+DFFF 的低代理项
+					if (u2 < 0xDC00 || u2 > 0xDFFF)
+						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+
+					//我们用下列公式把代理对 (H, L) 变换成真实的码点：
+					//codepoint = 0x10000 + (H − 0xD800) × 0x400 + (L − 0xDC00)
+					u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
+
+				}
+				//单独的低代理项编码之后不是合法的UTF-8
+				else if (c->validate_utf8 && u >= 0xDC00 && u <= 0xDFFF)
+					STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+
+				//转化为UTF-8编码格式
+				n = lept_encode_utf8(buf, u);
+				STRING_PUTS(buf, n);
+				break;
+			default:
+				//转移无效  更新top 跳过字符串
 				STRING_ERROR(LEPT_PARSE_INVALID_STRING_ESCAPE);
 			}
 			break;
@@ -317,9 +2508,7 @@ static int lept_parse_string_raw(lept_context* c, char** str, size_t* len) {
 			//因此，我们可以分配内存来储存解析后的字符，以及记录字符的数目（即字符串长度）。
 			//由于大部分 C 程序都假设字符串是空结尾字符串，我们还是在最后加上一个空字符，
 			//那么不需处理 \u0000 这种字符的应用可以简单地把它当作是空结尾字符串。
-		case '\0':   //错误
-			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
-
+			//文本中直接出现的'\0'和其他控制字符一样是不合法的字符  文本的结尾由 c->end 判断
 		default:
 			//unescaped = %x20-21 / %x23-5B / %x5D-10FFFF  合法的字符值
 			//当中空缺的 %x22 是双引号，%x5C 是反斜线，都已经处理
@@ -327,11 +2516,23 @@ static int lept_parse_string_raw(lept_context* c, char** str, size_t* len) {
 			if ((unsigned char)ch < 0x20)
 				//不合法字符值
 				STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
-			PUTC(c, ch);//push进栈 等到解析成功后出栈
+			STRING_PUTC(ch);//push进栈 等到解析成功后出栈
 		}
 	}
 }
 
+//把短字符串存放在结点中
+static void lept_set_inline_string(lept_value* v, const char* s, size_t len) {
+	assert(len <= LEPT_INLINE_STRING_MAX);
+	//空串的 s 可以是NULL  memcpy() 的参数即使长度为0也不能是NULL
+	if (len)
+		memcpy(LEPT_INLINE_S(v), s, len);
+	LEPT_INLINE_S(v)[len] = '\0';
+	LEPT_INLINE_LEN(v) = (unsigned char)len;
+	v->type = LEPT_STRING;
+	v->flags = LEPT_FLAG_INLINE;
+}
+
 //解析字符串
 static int lept_parse_string(lept_context* c, lept_value* v) {
 	int ret;
@@ -339,13 +2540,38 @@ static int lept_parse_string(lept_context* c, lept_value* v) {
 	size_t len;
 
 	//把解析 JSON 字符串及写入 lept_value 分拆成两部分   此处代码重构是方便于对象键值string的解析
-	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK)
-		lept_set_string(v, s, len);
+	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK) {
+		//短字符串直接存放在结点中  原地解析时仍然指向缓冲区  不需要复制
+		if (len <= LEPT_INLINE_STRING_MAX && !c->insitu) {
+			lept_set_inline_string(v, s, len);
+			return ret;
+		}
+		if (LEPT_SIZE_TOO_LARGE(len))
+			return LEPT_PARSE_TOO_LARGE;
+		v->u.s.s = c->insitu ? s : lept_context_strdup(c, s, len);
+		LEPT_S_LEN(v) = len;
+		v->type = LEPT_STRING;
+		v->flags = c->arena ? LEPT_FLAG_ARENA : c->insitu ? LEPT_FLAG_BORROWED : 0;
+	}
 	return ret;
 }
 
 static int lept_parse_value(lept_context* c, lept_value* v);//前向声明
 
+//把栈顶的size个元素弹出  组成数组v   size不能为0
+static void lept_context_pop_array(lept_context* c, lept_value* v, size_t size) {
+	//分配size个lept_value空间
+	v->type = LEPT_ARRAY;
+	v->u.a.e = (lept_value*)lept_context_alloc(c, (size + LEPT_ARRAY_HEAD) * sizeof(lept_value)) + LEPT_ARRAY_HEAD;
+	//将栈中所有的值复制到最终的e中
+	memcpy(v->u.a.e, lept_context_pop(c, size * sizeof(lept_value)), size * sizeof(lept_value));
+	//更新size
+	LEPT_A_SIZE(v) = size;
+	LEPT_SET_A_CAPACITY(v, size);
+	//在arena中解析出的数组  所有元素也都在arena中
+	v->flags = c->arena ? LEPT_FLAG_ARENA | LEPT_FLAG_SEALED : 0;
+}
+
 //解析数组
 static int lept_parse_array(lept_context* c, lept_value* v) {
 
@@ -360,7 +2586,7 @@ static int lept_parse_array(lept_context* c, lept_value* v) {
 
 	//我们只需要把每个解析好的元素压入堆栈，解析到数组结束时，
 	//再一次性把所有元素弹出，复制至新分配的内存之中
-	if (*c->json == ']') {
+	if (PEEK(c) == ']') {
 
 		//解析成功
 		c->json++;
@@ -385,20 +2611,18 @@ static int lept_parse_array(lept_context* c, lept_value* v) {
 
 		//JOSN数组语法  array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
 
-		if (*c->json == ',') {//有另一个值
+		if (PEEK(c) == ',') {//有另一个值
 			c->json++;
 			lept_parse_whitespace(c);
 		}
-		else if (*c->json == ']') {//没有另一个值
+		else if (PEEK(c) == ']') {//没有另一个值
+			if (LEPT_SIZE_TOO_LARGE(size)) {
+				ret = LEPT_PARSE_TOO_LARGE;
+				break;
+			}
 			//解析成功
 			c->json++;
-			//分配size个lept_value空间
-			lept_set_array(v, size);
-			//将栈中所有的值复制到最终的e中
-			memcpy(v->u.a.e, lept_context_pop(c, size * sizeof(lept_value)), size * sizeof(lept_value));
-			//更新size
-			v->u.a.size = size;
-
+			lept_context_pop_array(c, v, size);
 			return LEPT_PARSE_OK;
 		}
 		else {
@@ -407,11 +2631,251 @@ static int lept_parse_array(lept_context* c, lept_value* v) {
 			break;
 		}
 	}
-	/* Pop and free values on the stack */
-	for (i = 0; i < size; i++)
-		//将栈中开辟的所有值free   因为每次pop函数都会返回一个值的首地址更新top   所以free  size次就可以
-		lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
-	return ret;
+	/* Pop and free values on the stack */
+	for (i = 0; i < size; i++)
+		//将栈中开辟的所有值free   因为每次pop函数都会返回一个值的首地址更新top   所以free  size次就可以
+		lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
+	return ret;
+}
+
+//对象的哈希索引  开放寻址  线性探测
+//槽里存放成员下标+1  0表示空槽  槽数是2的幂并且至少是成员数的2倍
+//哈希函数是 SipHash-1-3  密钥是进程启动后第一次用到时从操作系统取得的随机数  构造大量碰撞的键来拖慢查找是不可行的
+typedef struct {
+	lept_uint64 key[2];
+	size_t mask;     //槽数-1
+	size_t slots[1]; //实际分配 mask+1 个
+}lept_object_index;
+
+#define LEPT_OBJECT_INDEX(v)        (*(lept_object_index**)((v)->u.o.m - 1))
+#define LEPT_OBJECT_INDEX_SIZE(n)   (sizeof(lept_object_index) + ((n) - 1) * sizeof(size_t))
+
+#define LEPT_ROTL64(x, b)   (((x) << (b)) | ((x) >> (64 - (b))))
+#define LEPT_SIPROUND(v0, v1, v2, v3) do { \
+		v0 += v1; v1 = LEPT_ROTL64(v1, 13); v1 ^= v0; v0 = LEPT_ROTL64(v0, 32); \
+		v2 += v3; v3 = LEPT_ROTL64(v3, 16); v3 ^= v2; \
+		v0 += v3; v3 = LEPT_ROTL64(v3, 21); v3 ^= v0; \
+		v2 += v1; v1 = LEPT_ROTL64(v1, 17); v1 ^= v2; v2 = LEPT_ROTL64(v2, 32); \
+	} while(0)
+
+static lept_uint64 lept_siphash(const lept_uint64 key[2], const char* s, size_t len) {
+	lept_uint64 v0 = key[0] ^ 0x736F6D6570736575ULL, v1 = key[1] ^ 0x646F72616E646F6DULL;
+	lept_uint64 v2 = key[0] ^ 0x6C7967656E657261ULL, v3 = key[1] ^ 0x7465646279746573ULL;
+	lept_uint64 m;
+	size_t i;
+	const char* end = s + (len & ~(size_t)7);
+	for (; s != end; s += 8) {
+		memcpy(&m, s, 8);
+		v3 ^= m;
+		LEPT_SIPROUND(v0, v1, v2, v3);
+		v0 ^= m;
+	}
+	//剩下的0~7个字节和长度的最低字节组成最后一个字
+	m = (lept_uint64)len << 56;
+	for (i = len & 7; i > 0; i--)
+		m |= (lept_uint64)(unsigned char)s[i - 1] << (8 * (i - 1));
+	v3 ^= m;
+	LEPT_SIPROUND(v0, v1, v2, v3);
+	v0 ^= m;
+	v2 ^= 0xFF;
+	LEPT_SIPROUND(v0, v1, v2, v3);
+	LEPT_SIPROUND(v0, v1, v2, v3);
+	LEPT_SIPROUND(v0, v1, v2, v3);
+	return v0 ^ v1 ^ v2 ^ v3;
+}
+
+//SplitMix64  用来把种子打散成密钥
+static lept_uint64 lept_mix64(lept_uint64 x) {
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+//从操作系统的随机数源读取 len 字节  失败返回0
+static int lept_os_random(void* buf, size_t len) {
+#ifdef _WIN32
+	return BCRYPT_SUCCESS(BCryptGenRandom(NULL, (PUCHAR)buf, (ULONG)len, BCRYPT_USE_SYSTEM_PREFERRED_RNG));
+#else
+	char* p = (char*)buf;
+	ssize_t n;
+	int fd;
+#ifdef LEPT_HAVE_GETRANDOM
+	//内核不支持 getrandom() 时(ENOSYS)改用 /dev/urandom
+	while (len > 0 && ((n = getrandom(p, len, 0)) > 0 || errno == EINTR))
+		if (n > 0) {
+			p += n;
+			len -= (size_t)n;
+		}
+	if (len == 0)
+		return 1;
+#endif
+	if ((fd = open("/dev/urandom", O_RDONLY)) < 0)
+		return 0;
+	while (len > 0 && ((n = read(fd, p, len)) > 0 || (n < 0 && errno == EINTR)))
+		if (n > 0) {
+			p += n;
+			len -= (size_t)n;
+		}
+	close(fd);
+	return len == 0;
+#endif
+}
+
+//对象索引  键的去重表和编译后的 JSON Pointer 共用的 SipHash 密钥  每个进程只取一次随机数
+//所有调用得到的密钥都相同  所以 lept_path_compile() 求出的哈希值可以直接用于任何对象的索引
+//多个线程同时第一次调用时  只有一个线程取随机数  其他线程等它保存好之后再读
+//取不到随机数(例如 chroot 中没有 /dev/urandom)时退回到时间和地址(ASLR)混合
+static void lept_hash_key(lept_uint64 key[2]) {
+	static lept_uint64 saved[2];
+	static volatile long state; //0 还没有取得  1 正在取得  2 已经保存
+	lept_uint64 seed;
+	if (LEPT_ATOMIC_CAS(&state, 0, 1)) {
+		if (!lept_os_random(saved, sizeof(saved))) {
+			seed = (lept_uint64)time(NULL) ^ (lept_uint64)(size_t)&seed;
+			saved[0] = lept_mix64(seed);
+			saved[1] = lept_mix64(saved[0] ^ (lept_uint64)(size_t)saved);
+		}
+		LEPT_ATOMIC_CAS(&state, 1, 2);
+	}
+	else
+		while (!LEPT_ATOMIC_CAS(&state, 2, 2))
+			;
+	key[0] = saved[0];
+	key[1] = saved[1];
+}
+
+//成员数 size 需要的槽数
+static size_t lept_object_index_slots(size_t size) {
+	size_t n = 32;
+	while (n < size * 2)
+		n <<= 1;
+	return n;
+}
+
+//初始化一块新分配的索引
+static void lept_object_index_init(lept_object_index* idx, size_t slots) {
+	lept_hash_key(idx->key);
+	idx->mask = slots - 1;
+}
+
+//把下标为 i 的成员加入索引  已经有相同的键时保留前面的  和线性查找的结果一致
+static void lept_object_index_put(lept_object_index* idx, const lept_member* m, size_t i) {
+	size_t h = (size_t)lept_siphash(idx->key, m[i].k, m[i].klen), j;
+	while ((j = idx->slots[h &= idx->mask]) != 0) {
+		if (m[j - 1].klen == m[i].klen && memcmp(m[j - 1].k, m[i].k, m[i].klen) == 0)
+			return;
+		h++;
+	}
+	idx->slots[h] = i + 1;
+}
+
+//清空索引并重新加入所有成员  槽数不变
+static void lept_object_index_fill(lept_object_index* idx, const lept_member* m, size_t size) {
+	size_t i;
+	memset(idx->slots, 0, (idx->mask + 1) * sizeof(size_t));
+	for (i = 0; i < size; i++)
+		lept_object_index_put(idx, m, i);
+}
+
+//h 是键的哈希值  所有索引的密钥都相同(见 lept_hash_key())  可以事先求出
+static size_t lept_object_index_get_hashed(const lept_object_index* idx, const lept_member* m, const char* key, size_t klen, size_t h) {
+	size_t j;
+	while ((j = idx->slots[h &= idx->mask]) != 0) {
+		if (m[j - 1].klen == klen && memcmp(m[j - 1].k, key, klen) == 0)
+			return j - 1;
+		h++;
+	}
+	return LEPT_KEY_NOT_EXIST;
+}
+
+static size_t lept_object_index_get(const lept_object_index* idx, const lept_member* m, const char* key, size_t klen) {
+	return lept_object_index_get_hashed(idx, m, key, klen, (size_t)lept_siphash(idx->key, key, klen));
+}
+
+//去重表的槽数翻倍(第一次分配64个)  重新放入所有的键
+static void lept_intern_grow(lept_intern* t) {
+	char** old = t->slots;
+	size_t n = old ? t->mask + 1 : 0, i, h;
+	if (old == NULL)
+		lept_hash_key(t->key);
+	t->mask = (n ? n * 2 : 64) - 1;
+	t->slots = (char**)calloc(t->mask + 1, sizeof(char*));
+	for (i = 0; i < n; i++)
+		if (old[i] != NULL) {
+			h = (size_t)lept_siphash(t->key, old[i], LEPT_KEY_HEADER(old[i])->len);
+			while (t->slots[h &= t->mask] != NULL)
+				h++;
+			t->slots[h] = old[i];
+		}
+	free(old);
+}
+
+//返回和 s 相同的共用的键(增加引用计数)   表中没有时新分配一个  表没有满时加入表中
+static char* lept_intern_key(lept_intern* t, const char* s, size_t len) {
+	size_t h;
+	char* k;
+	if (t->slots == NULL)
+		lept_intern_grow(t);
+	h = (size_t)lept_siphash(t->key, s, len);
+	while ((k = t->slots[h &= t->mask]) != NULL) {
+		if (LEPT_KEY_HEADER(k)->len == len && memcmp(k, s, len) == 0)
+			return lept_key_retain(k);
+		h++;
+	}
+	k = lept_key_new(s, len);
+	if (t->count < LEPT_INTERN_MAX_KEYS) {
+		t->slots[h] = lept_key_retain(k);
+		if (++t->count * 2 > t->mask + 1)
+			lept_intern_grow(t);
+	}
+	return k;
+}
+
+//放弃表持有的引用  已经解析出的值仍然可以使用这些键
+static void lept_intern_free(lept_intern* t) {
+	size_t i;
+	if (t->slots != NULL) {
+		for (i = 0; i <= t->mask; i++)
+			if (t->slots[i] != NULL)
+				lept_key_release(t->slots[i]);
+		free(t->slots);
+	}
+	t->slots = NULL;
+	t->mask = t->count = 0;
+}
+
+//释放解析失败时已经分配的键  arena中的键随文档释放  原地解析的键在缓冲区中
+static void lept_context_free_key(lept_context* c, char* k) {
+	if (c->intern != NULL) {
+		if (k != NULL)
+			lept_key_release(k);
+	}
+	else if (!c->arena && !c->insitu)
+		free(k);
+}
+
+//把栈顶的size个成员弹出  组成对象v   size不能为0
+static void lept_context_pop_object(lept_context* c, lept_value* v, size_t size) {
+	v->type = LEPT_OBJECT;
+	v->flags = c->arena ? LEPT_FLAG_ARENA | LEPT_FLAG_SEALED : c->insitu ? LEPT_FLAG_BORROWED : c->intern ? LEPT_FLAG_INTERNED : 0;
+	//成员多的对象直接建立索引  索引和成员数组一样从arena或者堆上分配
+	if (size > LEPT_OBJECT_INDEX_THRESHOLD) {
+		lept_object_index* idx;
+		v->u.o.m = (lept_member*)lept_context_alloc(c, sizeof(lept_member) * (size + 1)) + 1;
+		idx = (lept_object_index*)lept_context_alloc(c, LEPT_OBJECT_INDEX_SIZE(lept_object_index_slots(size)));
+		lept_object_index_init(idx, lept_object_index_slots(size));
+		LEPT_OBJECT_INDEX(v) = idx;
+		v->flags |= LEPT_FLAG_INDEXED;
+	}
+	else
+		v->u.o.m = (lept_member*)lept_context_alloc(c, sizeof(lept_member) * (size + LEPT_OBJECT_HEAD)) + LEPT_OBJECT_HEAD;
+	//出栈并复制到最终v
+	memcpy(v->u.o.m, lept_context_pop(c, sizeof(lept_member) * size), sizeof(lept_member) * size);
+	LEPT_O_SIZE(v) = size;
+	LEPT_SET_O_CAPACITY(v, size);
+	if (v->flags & LEPT_FLAG_INDEXED)
+		lept_object_index_fill(LEPT_OBJECT_INDEX(v), v->u.o.m, size);
 }
 
 //解析对象
@@ -430,7 +2894,7 @@ static int lept_parse_object(lept_context* c, lept_value* v) {
 
 	lept_parse_whitespace(c);
 
-	if (*c->json == '}') {
+	if (PEEK(c) == '}') {
 		//解析成功
 		c->json++;
 		lept_set_object(v, 0);//空对象
@@ -446,7 +2910,7 @@ static int lept_parse_object(lept_context* c, lept_value* v) {
 		lept_init(&m.v);
 
 		/* parse key 键*/
-		if (*c->json != '"') {
+		if (PEEK(c) != '"') {
 			ret = LEPT_PARSE_MISS_KEY;
 			break;
 		}
@@ -454,14 +2918,13 @@ static int lept_parse_object(lept_context* c, lept_value* v) {
 		//解析键值string
 		if ((ret = lept_parse_string_raw(c, &str, &m.klen)) != LEPT_PARSE_OK)
 			break;
-		memcpy(m.k = (char*)malloc(m.klen + 1), str, m.klen);//临时mmber分配内存
-		m.k[m.klen] = '\0';//记得封死字符指针
+		m.k = c->insitu ? str : c->intern ? lept_intern_key(c->intern, str, m.klen) : lept_context_strdup(c, str, m.klen);//临时mmber分配内存  记得封死字符指针
 
 		/* parse ws colon ws */
 		lept_parse_whitespace(c);
 
 		//member = string ws %x3A ws value
-		if (*c->json != ':') {
+		if (PEEK(c) != ':') {
 			ret = LEPT_PARSE_MISS_COLON;
 			break;
 		}
@@ -483,143 +2946,1193 @@ static int lept_parse_object(lept_context* c, lept_value* v) {
 		/* parse ws [comma | right-curly-brace] ws */
 		lept_parse_whitespace(c);
 
-		if (*c->json == ',') {//有其他值
+		if (PEEK(c) == ',') {//有其他值
 			//递归调用 lept_parse_value()，
 			//把结果写入临时 lept_member 的 v 字段，
 			//然后把整个 lept_member 压入栈：   与数组相似
 			c->json++;
 			lept_parse_whitespace(c);
 		}
-		else if (*c->json == '}') {//没有其他值
+		else if (PEEK(c) == '}') {//没有其他值
+			if (LEPT_SIZE_TOO_LARGE(size)) {
+				ret = LEPT_PARSE_TOO_LARGE;
+				break;
+			}
 			c->json++;
-			lept_set_object(v, size);
-			//出栈并复制到最终v
-			memcpy(v->u.o.m, lept_context_pop(c, sizeof(lept_member) * size), sizeof(lept_member) * size);
-			v->u.o.size = size;
+			lept_context_pop_object(c, v, size);
 			//解析成功
 			return LEPT_PARSE_OK;
 		}
-		else {//解析失败   即没逗号也没花括号
-			ret = LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+		else {//解析失败   即没逗号也没花括号
+			ret = LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+			break;
+		}
+	}
+
+	/* Pop and free members on the stack */
+	//arena中的键不用释放  在文档销毁或者重新解析时一起释放  原地解析的键在缓冲区中
+	lept_context_free_key(c, m.k);//释放临时字符串
+	for (i = 0; i < size; i++) {
+
+		//释放存放在栈上的成员空间
+		lept_member* m = (lept_member*)lept_context_pop(c, sizeof(lept_member));
+		lept_context_free_key(c, m->k);
+		lept_free(&m->v);
+	}
+	v->type = LEPT_NULL;
+
+	//而v的内存则是在测试完成时释放
+	return ret;
+}
+
+//解析函数接口 返回解析结果
+static int lept_parse_value(lept_context* c, lept_value* v) {
+	if (c->json == c->end)
+		return LEPT_PARSE_EXPECT_VALUE;
+	switch (*c->json) {
+
+		//由于解析 t  f   n代码过程相似   为了节约代码空间   合并成一个解析函数
+	case 't':  return lept_parse_literal(c, v, "true", LEPT_TRUE);
+	case 'f':  return lept_parse_literal(c, v, "false", LEPT_FALSE);
+	case 'n':  return lept_parse_literal(c, v, "null", LEPT_NULL);
+
+	case '"':  return lept_parse_string(c, v);
+
+	case '[':  return lept_parse_array(c, v);
+
+	case '{':  return lept_parse_object(c, v);
+
+	default:   return lept_parse_number(c, v);
+	}
+}
+
+
+//SAX解析  和上面的 lept_parse_*() 使用同样的词法分析  但不建立结点  每个值都作为事件交给 c->handler
+//字符串仍然在栈中解码  传给事件函数之后立即出栈  数组和对象不使用栈
+//handler 中为NULL的函数忽略  事件函数返回0时停止解析
+#define SAX_EVENT(f, args) do { if (c->handler->f && !c->handler->f args) return LEPT_PARSE_STOPPED; } while(0)
+
+static int lept_sax_parse_value(lept_context* c);
+
+static int lept_sax_parse_array(lept_context* c) {
+	size_t size = 0;
+	int ret;
+
+	EXPECT(c, '[');
+	SAX_EVENT(on_start_array, (c->user));
+	lept_parse_whitespace(c);
+	if (PEEK(c) == ']') {
+		c->json++;
+		SAX_EVENT(on_end_array, (c->user, 0));
+		return LEPT_PARSE_OK;
+	}
+	for (;;) {
+		if ((ret = lept_sax_parse_value(c)) != LEPT_PARSE_OK)
+			return ret;
+		size++;
+		lept_parse_whitespace(c);
+		if (PEEK(c) == ',') {
+			c->json++;
+			lept_parse_whitespace(c);
+		}
+		else if (PEEK(c) == ']') {
+			c->json++;
+			SAX_EVENT(on_end_array, (c->user, size));
+			return LEPT_PARSE_OK;
+		}
+		else
+			return LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+	}
+}
+
+static int lept_sax_parse_object(lept_context* c) {
+	size_t size = 0, klen;
+	char* key;
+	int ret;
+
+	EXPECT(c, '{');
+	SAX_EVENT(on_start_object, (c->user));
+	lept_parse_whitespace(c);
+	if (PEEK(c) == '}') {
+		c->json++;
+		SAX_EVENT(on_end_object, (c->user, 0));
+		return LEPT_PARSE_OK;
+	}
+	for (;;) {
+		if (PEEK(c) != '"')
+			return LEPT_PARSE_MISS_KEY;
+		if ((ret = lept_parse_string_raw(c, &key, &klen)) != LEPT_PARSE_OK)
+			return ret;
+		SAX_EVENT(on_key, (c->user, key, klen));
+		lept_parse_whitespace(c);
+		if (PEEK(c) != ':')
+			return LEPT_PARSE_MISS_COLON;
+		c->json++;
+		lept_parse_whitespace(c);
+		if ((ret = lept_sax_parse_value(c)) != LEPT_PARSE_OK)
+			return ret;
+		size++;
+		lept_parse_whitespace(c);
+		if (PEEK(c) == ',') {
+			c->json++;
+			lept_parse_whitespace(c);
+		}
+		else if (PEEK(c) == '}') {
+			c->json++;
+			SAX_EVENT(on_end_object, (c->user, size));
+			return LEPT_PARSE_OK;
+		}
+		else
+			return LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+	}
+}
+
+//字面值和数字解析到栈上的临时 lept_value 中  不需要分配内存
+static int lept_sax_parse_value(lept_context* c) {
+	lept_value v;
+	char* s;
+	size_t len;
+	int ret;
+
+	if (c->json == c->end)
+		return LEPT_PARSE_EXPECT_VALUE;
+	lept_init(&v);
+	switch (*c->json) {
+	case 't':
+	case 'f':
+		if ((ret = *c->json == 't' ? lept_parse_literal(c, &v, "true", LEPT_TRUE) : lept_parse_literal(c, &v, "false", LEPT_FALSE)) != LEPT_PARSE_OK)
+			return ret;
+		SAX_EVENT(on_bool, (c->user, v.type == LEPT_TRUE));
+		return LEPT_PARSE_OK;
+	case 'n':
+		if ((ret = lept_parse_literal(c, &v, "null", LEPT_NULL)) != LEPT_PARSE_OK)
+			return ret;
+		SAX_EVENT(on_null, (c->user));
+		return LEPT_PARSE_OK;
+	case '"':
+		if ((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK)
+			return ret;
+		SAX_EVENT(on_string, (c->user, s, len));
+		return LEPT_PARSE_OK;
+	case '[':  return lept_sax_parse_array(c);
+	case '{':  return lept_sax_parse_object(c);
+	default:
+		if ((ret = lept_parse_number(c, &v)) != LEPT_PARSE_OK)
+			return ret;
+		SAX_EVENT(on_number, (c->user, &v));
+		return LEPT_PARSE_OK;
+	}
+}
+
+//API函数     SAX解析长度为len的JSON文本   不建立 lept_value 树   事件函数返回0时停止并返回 LEPT_PARSE_STOPPED
+int lept_parse_sax(const lept_handler* handler, void* user, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(handler != NULL && (json != NULL || len == 0));
+
+	lept_context_init(&c, NULL, 0);
+	c.handler = handler;
+	c.user = user;
+	c.json = json;
+	c.end = json + len;
+	lept_parse_whitespace(&c);
+	if ((ret = lept_sax_parse_value(&c)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(&c);
+		if (c.json != c.end)
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+	}
+	free(c.stack);
+	return ret;
+}
+
+
+//API函数     解析JSON函数  json 是以'\0'结尾的文本
+int lept_parse(lept_value* v, const char* json) {
+	assert(json != NULL);
+	return lept_parse_n(v, json, strlen(json));
+}
+
+//解析JSON文本   c 的栈和arena由调用者准备  解析结束时栈为空
+static int lept_parse_text(lept_context* c, lept_value* v, const char* json, size_t len) {
+
+	//JSON - text = ws value ws
+
+	int ret;
+	assert(v != NULL && (json != NULL || len == 0));
+
+	c->json = json;
+	c->end = json + len;
+	lept_init(v);
+
+	//第一个w
+	lept_parse_whitespace(c);
+
+	//value
+	//ret来记录解析结果  如果解析成功就继续
+	if ((ret = lept_parse_value(c, v)) == LEPT_PARSE_OK)
+	{
+
+		//第二个w
+		lept_parse_whitespace(c);
+
+		//如果第二个w后边还有数   说明不满足JSON语法  
+		if (c->json != c->end)
+		{
+			//释放解析结果 变为null
+			lept_free(v);
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+		}
+
+	}
+
+	assert(c->top == 0);//加入断言确保所有数据都被弹出
+	return ret;
+}
+
+//API函数     解析长度为len的JSON文本   文本不需要以'\0'结尾  可以直接解析大缓冲区中的一段而不用复制
+int lept_parse_n(lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+
+	//初始化stack   并最终释放内存
+	lept_context_init(&c, NULL, 0);
+	ret = lept_parse_text(&c, v, json, len);
+	free(c.stack);
+	return ret;
+}
+
+//API函数     两阶段解析  结果和错误码都和 lept_parse_n() 相同
+//第一阶段用SIMD一次处理64字节  找出结构字符和字符串结束引号的位置   第二阶段用同样的递归下降建立 lept_value 树
+//但遇到空白时直接跳到下一个结构字符  没有转义的字符串直接从开始引号复制到结束引号  不再逐字节扫描
+//两个阶段按窗口交替进行  位置用32位存储(最高位是标记)  2GB以上的文本直接用 lept_parse_n() 解析
+int lept_parse_two_stage(lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	lept_two_stage* t;
+	int ret;
+	assert(v != NULL && (json != NULL || len == 0));
+
+	if (len >= LEPT_INDEX_DIRTY)
+		return lept_parse_n(v, json, len);
+	t = (lept_two_stage*)malloc(sizeof(lept_two_stage));
+	lept_stage1_init(t, json, len);
+	lept_context_init(&c, NULL, 0);
+	c.stage = t;
+	ret = lept_parse_text(&c, v, json, len);
+	free(c.stack);
+	free(t);
+	return ret;
+}
+
+//API函数     原地解析  字符串和对象的键在 json 中解码并以'\0'结尾  解析结果直接指向 json
+//json 的内容被破坏(解析失败时也一样)  并且必须比解析结果活得久
+int lept_parse_insitu(lept_value* v, char* json, size_t len) {
+	lept_context c;
+	int ret;
+	lept_context_init(&c, NULL, 1);
+	ret = lept_parse_text(&c, v, json, len);
+	free(c.stack);
+	return ret;
+}
+
+//创建解析器  栈在第一次解析时分配
+lept_parser* lept_parser_create(void) {
+	lept_parser* p = (lept_parser*)malloc(sizeof(lept_parser));
+	p->stack = NULL;
+	p->size = 0;
+	p->trim_size = LEPT_PARSER_TRIM_SIZE;
+	p->intern_keys = 0;
+	p->intern.slots = NULL;
+	p->intern.mask = p->intern.count = 0;
+	p->validate_utf8 = 0;
+	return p;
+}
+
+void lept_parser_destroy(lept_parser* p) {
+	assert(p != NULL);
+	free(p->stack);
+	lept_intern_free(&p->intern);
+	free(p);
+}
+
+//释放解析器的栈和去重表  之后仍然可以继续使用
+void lept_parser_reset(lept_parser* p) {
+	assert(p != NULL);
+	free(p->stack);
+	p->stack = NULL;
+	p->size = 0;
+	lept_intern_free(&p->intern);
+}
+
+//打开/关闭对象的键的去重  去重表在多次解析之间保留  关闭时释放
+void lept_parser_set_intern_keys(lept_parser* p, int intern_keys) {
+	assert(p != NULL);
+	p->intern_keys = intern_keys;
+	if (!intern_keys)
+		lept_intern_free(&p->intern);
+}
+
+//打开/关闭UTF-8校验
+void lept_parser_set_validate_utf8(lept_parser* p, int validate_utf8) {
+	assert(p != NULL);
+	p->validate_utf8 = validate_utf8;
+}
+
+//设置每次解析后保留的栈的最大值  小于栈的初始大小时每次解析后都释放栈
+void lept_parser_set_trim_size(lept_parser* p, size_t trim_size) {
+	assert(p != NULL);
+	p->trim_size = trim_size;
+}
+
+//和 lept_parse_n() 相同  但使用解析器保留的栈
+int lept_parser_parse(lept_parser* p, lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(p != NULL);
+
+	lept_context_init(&c, NULL, 0);
+	c.stack = p->stack;
+	c.size = p->size;
+	c.intern = p->intern_keys ? &p->intern : NULL;
+	c.validate_utf8 = p->validate_utf8;
+	ret = lept_parse_text(&c, v, json, len);
+	p->stack = c.stack;
+	p->size = c.size;
+
+	//栈超过了保留的大小  缩小回去(太小时直接释放  下次从初始大小开始)   只释放栈  去重表保留
+	if (p->size > p->trim_size) {
+		if (p->trim_size < LEPT_PARSE_STACK_INIT_SIZE) {
+			free(p->stack);
+			p->stack = NULL;
+			p->size = 0;
+		}
+		else
+			p->stack = (char*)realloc(p->stack, p->size = p->trim_size);
+	}
+	return ret;
+}
+
+//创建一个空的文档  根结点为null
+lept_document* lept_document_create(void) {
+	lept_document* doc = (lept_document*)malloc(sizeof(lept_document));
+	lept_init(&doc->root);
+	doc->arena.head = NULL;
+	doc->arena.cur = doc->arena.end = NULL;
+	return doc;
+}
+
+//销毁文档  只需要遍历解析后被修改过的结点  其余部分随arena一起释放
+void lept_document_destroy(lept_document* doc) {
+	assert(doc != NULL);
+	lept_free(&doc->root);
+	lept_arena_free(&doc->arena);
+	free(doc);
+}
+
+//解析到文档中  原来的内容全部释放  arena最大的一块留给这次解析使用
+int lept_document_parse(lept_document* doc, const char* json) {
+	assert(json != NULL);
+	return lept_document_parse_n(doc, json, strlen(json));
+}
+
+int lept_document_parse_n(lept_document* doc, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(doc != NULL);
+	lept_free(&doc->root);
+	lept_arena_reset(&doc->arena);
+	lept_context_init(&c, &doc->arena, 0);
+	ret = lept_parse_text(&c, &doc->root, json, len);
+	free(c.stack);
+	return ret;
+}
+
+//文档的根结点  可以用所有的访问和修改函数操作
+lept_value* lept_document_root(lept_document* doc) {
+	assert(doc != NULL);
+	return &doc->root;
+}
+
+//push解析器  文本分成多块依次传入  解析状态在两块之间保存
+//和DOM解析一样  还没有结束的数组/对象的元素保存在栈中  每个数组/对象在它的元素下面有一个 lept_push_frame
+//完整落在一块中的字符串和数字直接解析   跨越两块的先把原文保存在 token 中  结束后再用同样的函数解析
+//所以错误码和 lept_parse() 解析拼接起来的文本时相同
+typedef struct {
+	size_t parent; //外层数组/对象的 lept_push_frame 在栈中的位置
+	size_t count;  //已经完成的元素/成员个数
+	int object;    //1: 对象  0: 数组
+	int pending;   //对象最后一个成员的键已经入栈  值还没有完成
+}lept_push_frame;
+
+enum {
+	LEPT_PUSH_VALUE,         //期待一个值
+	LEPT_PUSH_FIRST_ELEMENT, //'['之后  期待值或者']'
+	LEPT_PUSH_FIRST_MEMBER,  //'{'之后  期待键或者'}'
+	LEPT_PUSH_KEY,           //对象中','之后  期待键
+	LEPT_PUSH_COLON,         //键之后  期待':'
+	LEPT_PUSH_AFTER_VALUE,   //一个值结束之后  期待','或者']'/'}'  根结点之后只能有空白
+	LEPT_PUSH_STRING,        //字符串(或者键)还没有结束  原文在 token 中
+	LEPT_PUSH_NUMBER,        //数字可能还没有结束  原文在 token 中
+	LEPT_PUSH_LITERAL        //true/false/null 还没有结束
+};
+
+struct lept_push_parser {
+	lept_context c;      //栈中保存还没有结束的数组/对象和它们的元素
+	size_t frame;        //最内层数组/对象的 lept_push_frame 在栈中的位置
+	size_t depth;        //还没有结束的数组/对象的层数
+	int state;
+	int ret;             //还没有完成时为 LEPT_PARSE_NEED_MORE  根结点完成后为 LEPT_PARSE_OK  出错之后保持错误码
+	int is_key;          //LEPT_PUSH_STRING: 在解析对象的键
+	int escaped;         //LEPT_PUSH_STRING: token 以还没有配对的反斜线结尾
+	const char* literal; //LEPT_PUSH_LITERAL: 要匹配的字面值和已经匹配的字符数
+	size_t matched;
+	char* token;         //跨越两块的字符串/数字的原文
+	size_t token_len, token_size;
+	lept_value root;
+};
+
+#define LEPT_PUSH_FAILED(p)  ((p)->ret != LEPT_PARSE_OK && (p)->ret != LEPT_PARSE_NEED_MORE)
+#define LEPT_PUSH_FRAME(p)   ((lept_push_frame*)((p)->c.stack + (p)->frame))
+
+static void lept_push_run(lept_push_parser* p, const char* s, const char* end);
+
+static void lept_push_token(lept_push_parser* p, const char* s, size_t len) {
+	if (p->token_len + len > p->token_size) {
+		while (p->token_len + len > p->token_size)
+			p->token_size = p->token_size ? p->token_size + (p->token_size >> 1) : 64;
+		p->token = (char*)realloc(p->token, p->token_size);
+	}
+	memcpy(p->token + p->token_len, s, len);
+	p->token_len += len;
+}
+
+//找到字符串结尾的引号   *escaped 表示上一块以反斜线结尾  这一块的第一个字符被转义
+//找不到时返回NULL   字符串中的错误留给 lept_parse_string_raw() 发现
+static const char* lept_push_find_quote(const char* s, const char* end, int* escaped) {
+	if (*escaped) {
+		if (s == end)
+			return NULL;
+		s++;
+		*escaped = 0;
+	}
+	for (;;) {
+		s = lept_scan_string(s, end);
+		if (s == end)
+			return NULL;
+		if (*s == '"')
+			return s;
+		if (*s == '\\' && ++s == end) {
+			*escaped = 1;
+			return NULL;
+		}
+		s++;
+	}
+}
+
+//数字可能包含的字符  遇到其他字符时数字一定已经结束
+static const char* lept_push_number_end(const char* s, const char* end) {
+	while (s != end && (ISDIGIT(*s) || *s == '-' || *s == '+' || *s == '.' || *s == 'e' || *s == 'E'))
+		s++;
+	return s;
+}
+
+//一个值完成  放入外层的数组/对象  或者成为根结点
+static void lept_push_value(lept_push_parser* p, lept_value* v) {
+	if (p->depth == 0) {
+		memcpy(&p->root, v, sizeof(lept_value));
+		p->ret = LEPT_PARSE_OK;
+	}
+	else if (LEPT_PUSH_FRAME(p)->object) {
+		memcpy(&((lept_member*)(p->c.stack + p->c.top) - 1)->v, v, sizeof(lept_value));
+		LEPT_PUSH_FRAME(p)->pending = 0;
+		LEPT_PUSH_FRAME(p)->count++;
+	}
+	else {
+		memcpy(lept_context_push(&p->c, sizeof(lept_value)), v, sizeof(lept_value));
+		LEPT_PUSH_FRAME(p)->count++;
+	}
+	p->state = LEPT_PUSH_AFTER_VALUE;
+}
+
+static void lept_push_open(lept_push_parser* p, int object) {
+	lept_push_frame f;
+	f.parent = p->frame;
+	f.count = 0;
+	f.object = object;
+	f.pending = 0;
+	p->frame = p->c.top;
+	memcpy(lept_context_push(&p->c, sizeof(lept_push_frame)), &f, sizeof(lept_push_frame));
+	p->depth++;
+	p->state = object ? LEPT_PUSH_FIRST_MEMBER : LEPT_PUSH_FIRST_ELEMENT;
+}
+
+//最内层的数组/对象结束  元素出栈组成一个值
+static void lept_push_close(lept_push_parser* p) {
+	lept_push_frame f;
+	lept_value v;
+	memcpy(&f, LEPT_PUSH_FRAME(p), sizeof(lept_push_frame));
+	lept_init(&v);
+	if (f.count == 0 && f.object)
+		lept_set_object(&v, 0);
+	else if (f.count == 0)
+		lept_set_array(&v, 0);
+	else if (f.object)
+		lept_context_pop_object(&p->c, &v, f.count);
+	else
+		lept_context_pop_array(&p->c, &v, f.count);
+	lept_context_pop(&p->c, sizeof(lept_push_frame));
+	p->frame = f.parent;
+	p->depth--;
+	lept_push_value(p, &v);
+}
+
+//解析[s, end)中的字符串  作为值或者对象的键   到 end 还没有结束时是错误
+static void lept_push_string(lept_push_parser* p, const char* s, const char* end) {
+	lept_context* c = &p->c;
+	lept_member m;
+	lept_value v;
+	char* str;
+	size_t len;
+	c->json = s;
+	c->end = end;
+	if ((p->ret = lept_parse_string_raw(c, &str, &len)) != LEPT_PARSE_OK)
+		return;
+	if (!p->is_key && LEPT_SIZE_TOO_LARGE(len)) {
+		p->ret = LEPT_PARSE_TOO_LARGE;
+		return;
+	}
+	p->ret = LEPT_PARSE_NEED_MORE;
+	if (p->is_key) {
+		m.k = lept_context_strdup(c, str, len);
+		m.klen = len;
+		lept_init(&m.v);
+		memcpy(lept_context_push(c, sizeof(lept_member)), &m, sizeof(lept_member));
+		LEPT_PUSH_FRAME(p)->pending = 1;
+		p->state = LEPT_PUSH_COLON;
+	}
+	else {
+		if (len <= LEPT_INLINE_STRING_MAX)
+			lept_set_inline_string(&v, str, len);
+		else {
+			v.u.s.s = lept_context_strdup(c, str, len);
+			LEPT_S_LEN(&v) = len;
+			v.type = LEPT_STRING;
+			v.flags = 0;
+		}
+		lept_push_value(p, &v);
+	}
+}
+
+//开始一个字符串  结尾的引号在这一块中时直接解析  否则存入 token   s 指向开头的引号
+static const char* lept_push_begin_string(lept_push_parser* p, const char* s, const char* end) {
+	const char* q;
+	p->escaped = 0;
+	if ((q = lept_push_find_quote(s + 1, end, &p->escaped)) == NULL) {
+		p->token_len = 0;
+		lept_push_token(p, s, (size_t)(end - s));
+		p->state = LEPT_PUSH_STRING;
+		return end;
+	}
+	lept_push_string(p, s, q + 1);
+	return q + 1;
+}
+
+//解析 token 中的数字   后面紧跟着的其他字符按照数字之后的字符处理(一定是错误)
+static void lept_push_number(lept_push_parser* p) {
+	lept_context* c = &p->c;
+	lept_value v;
+	lept_init(&v);
+	c->json = p->token;
+	c->end = p->token + p->token_len;
+	if ((p->ret = lept_parse_number(c, &v)) != LEPT_PARSE_OK)
+		return;
+	p->ret = LEPT_PARSE_NEED_MORE;
+	lept_push_value(p, &v);
+	if (c->json != c->end)
+		lept_push_run(p, c->json, c->end);
+}
+
+//开始一个值   s 不是空白
+static const char* lept_push_begin_value(lept_push_parser* p, const char* s, const char* end) {
+	lept_context* c = &p->c;
+	lept_value v;
+	const char* q;
+	switch (*s) {
+	case '[':  lept_push_open(p, 0); return s + 1;
+	case '{':  lept_push_open(p, 1); return s + 1;
+	case '"':
+		p->is_key = 0;
+		return lept_push_begin_string(p, s, end);
+	case 't':  p->literal = "true"; break;
+	case 'f':  p->literal = "false"; break;
+	case 'n':  p->literal = "null"; break;
+	default:
+		if (*s != '-' && !ISDIGIT(*s)) {
+			p->ret = LEPT_PARSE_INVALID_VALUE;
+			return s;
+		}
+		if ((q = lept_push_number_end(s, end)) == end) {
+			p->token_len = 0;
+			lept_push_token(p, s, (size_t)(end - s));
+			p->state = LEPT_PUSH_NUMBER;
+			return end;
+		}
+		lept_init(&v);
+		c->json = s;
+		c->end = end;
+		if ((p->ret = lept_parse_number(c, &v)) != LEPT_PARSE_OK)
+			return s;
+		p->ret = LEPT_PARSE_NEED_MORE;
+		lept_push_value(p, &v);
+		return c->json;
+	}
+	p->matched = 0;
+	p->state = LEPT_PUSH_LITERAL;
+	return s;
+}
+
+//处理一块文本
+static void lept_push_run(lept_push_parser* p, const char* s, const char* end) {
+	const char* q;
+	lept_value v;
+	int object;
+
+	while (s != end && !LEPT_PUSH_FAILED(p)) {
+		switch (p->state) {
+		case LEPT_PUSH_STRING:
+			if ((q = lept_push_find_quote(s, end, &p->escaped)) == NULL) {
+				lept_push_token(p, s, (size_t)(end - s));
+				return;
+			}
+			lept_push_token(p, s, (size_t)(q + 1 - s));
+			s = q + 1;
+			lept_push_string(p, p->token, p->token + p->token_len);
+			continue;
+		case LEPT_PUSH_NUMBER:
+			q = lept_push_number_end(s, end);
+			lept_push_token(p, s, (size_t)(q - s));
+			s = q;
+			if (s != end)
+				lept_push_number(p);
+			continue;
+		case LEPT_PUSH_LITERAL:
+			for (; s != end && p->literal[p->matched]; s++, p->matched++)
+				if (*s != p->literal[p->matched]) {
+					p->ret = LEPT_PARSE_INVALID_VALUE;
+					return;
+				}
+			if (!p->literal[p->matched]) {
+				lept_init(&v);
+				v.type = p->literal[0] == 't' ? LEPT_TRUE : p->literal[0] == 'f' ? LEPT_FALSE : LEPT_NULL;
+				lept_push_value(p, &v);
+			}
+			continue;
+		}
+
+		if ((s = lept_skip_whitespace(s, end)) == end)
+			return;
+		switch (p->state) {
+		case LEPT_PUSH_FIRST_ELEMENT:
+			if (*s == ']') {
+				lept_push_close(p);
+				s++;
+				break;
+			}
+			/* fall through */
+		case LEPT_PUSH_VALUE:
+			s = lept_push_begin_value(p, s, end);
+			break;
+		case LEPT_PUSH_FIRST_MEMBER:
+			if (*s == '}') {
+				lept_push_close(p);
+				s++;
+				break;
+			}
+			/* fall through */
+		case LEPT_PUSH_KEY:
+			if (*s != '"') {
+				p->ret = LEPT_PARSE_MISS_KEY;
+				return;
+			}
+			p->is_key = 1;
+			s = lept_push_begin_string(p, s, end);
+			break;
+		case LEPT_PUSH_COLON:
+			if (*s != ':') {
+				p->ret = LEPT_PARSE_MISS_COLON;
+				return;
+			}
+			s++;
+			p->state = LEPT_PUSH_VALUE;
+			break;
+		case LEPT_PUSH_AFTER_VALUE:
+			if (p->depth == 0) {
+				p->ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+				return;
+			}
+			object = LEPT_PUSH_FRAME(p)->object;
+			if (*s == ',') {
+				s++;
+				p->state = object ? LEPT_PUSH_KEY : LEPT_PUSH_VALUE;
+			}
+			else if (*s == (object ? '}' : ']')) {
+				if (LEPT_SIZE_TOO_LARGE(LEPT_PUSH_FRAME(p)->count)) {
+					p->ret = LEPT_PARSE_TOO_LARGE;
+					return;
+				}
+				s++;
+				lept_push_close(p);
+			}
+			else {
+				p->ret = object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+				return;
+			}
 			break;
 		}
 	}
+}
 
-	/* Pop and free members on the stack */
-	free(m.k);//释放临时字符串
-	for (i = 0; i < size; i++) {
-
-		//释放存放在栈上的成员空间
-		lept_member* m = (lept_member*)lept_context_pop(c, sizeof(lept_member));
-		free(m->k);
-		lept_free(&m->v);
+//释放还没有结束的数组/对象和根结点  回到初始状态  栈和 token 的内存保留给下一个文本
+static void lept_push_reset(lept_push_parser* p) {
+	lept_push_frame f;
+	lept_member* m;
+	size_t i;
+	while (p->depth > 0) {
+		memcpy(&f, LEPT_PUSH_FRAME(p), sizeof(lept_push_frame));
+		for (i = 0; i < f.count + f.pending; i++) {
+			if (f.object) {
+				m = (lept_member*)lept_context_pop(&p->c, sizeof(lept_member));
+				free(m->k);
+				lept_free(&m->v);
+			}
+			else
+				lept_free((lept_value*)lept_context_pop(&p->c, sizeof(lept_value)));
+		}
+		lept_context_pop(&p->c, sizeof(lept_push_frame));
+		p->frame = f.parent;
+		p->depth--;
 	}
-	v->type = LEPT_NULL;
+	assert(p->c.top == 0);
+	lept_free(&p->root);
+	p->frame = 0;
+	p->state = LEPT_PUSH_VALUE;
+	p->ret = LEPT_PARSE_NEED_MORE;
+	p->token_len = 0;
+}
 
-	//而v的内存则是在测试完成时释放
-	return ret;
+lept_push_parser* lept_push_parser_create(void) {
+	lept_push_parser* p = (lept_push_parser*)malloc(sizeof(lept_push_parser));
+	lept_context_init(&p->c, NULL, 0);
+	p->depth = 0;
+	p->token = NULL;
+	p->token_size = 0;
+	lept_init(&p->root);
+	lept_push_reset(p);
+	return p;
 }
 
-//解析函数接口 返回解析结果
-static int lept_parse_value(lept_context* c, lept_value* v) {
-	switch (*c->json) {
+void lept_push_parser_destroy(lept_push_parser* p) {
+	assert(p != NULL);
+	lept_push_reset(p);
+	free(p->c.stack);
+	free(p->token);
+	free(p);
+}
 
-		//由于解析 t  f   n代码过程相似   为了节约代码空间   合并成一个解析函数
-	case 't':  return lept_parse_literal(c, v, "true", LEPT_TRUE);
-	case 'f':  return lept_parse_literal(c, v, "false", LEPT_FALSE);
-	case 'n':  return lept_parse_literal(c, v, "null", LEPT_NULL);
+//传入下一块文本   返回 LEPT_PARSE_NEED_MORE 表示根结点还没有结束  LEPT_PARSE_OK 表示根结点已经结束(之后只能是空白)
+//出错时返回错误码  之后的文本都被忽略
+int lept_push_parser_feed(lept_push_parser* p, const char* chunk, size_t len) {
+	assert(p != NULL && (chunk != NULL || len == 0));
+	lept_push_run(p, chunk, chunk + len);
+	return p->ret;
+}
 
-	case '"':  return lept_parse_string(c, v);
+//文本结束  解析成功时结果移到v中   之后解析器回到初始状态  可以解析下一个文本
+int lept_push_parser_finish(lept_push_parser* p, lept_value* v) {
+	int ret;
+	assert(p != NULL && v != NULL);
+	//结束还没有完成的字符串/数字/字面值
+	if (!LEPT_PUSH_FAILED(p)) {
+		if (p->state == LEPT_PUSH_STRING)
+			lept_push_string(p, p->token, p->token + p->token_len);
+		else if (p->state == LEPT_PUSH_NUMBER)
+			lept_push_number(p);
+		else if (p->state == LEPT_PUSH_LITERAL)
+			p->ret = LEPT_PARSE_INVALID_VALUE;
+	}
+	//文本在期待某个字符的地方结束  和DOM解析遇到结尾时的错误相同
+	if (p->ret == LEPT_PARSE_NEED_MORE) {
+		switch (p->state) {
+		case LEPT_PUSH_FIRST_MEMBER:
+		case LEPT_PUSH_KEY:         p->ret = LEPT_PARSE_MISS_KEY; break;
+		case LEPT_PUSH_COLON:       p->ret = LEPT_PARSE_MISS_COLON; break;
+		case LEPT_PUSH_AFTER_VALUE: p->ret = LEPT_PUSH_FRAME(p)->object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET; break;
+		default:                    p->ret = LEPT_PARSE_EXPECT_VALUE; break;
+		}
+	}
+	ret = p->ret;
+	lept_init(v);
+	if (ret == LEPT_PARSE_OK) {
+		memcpy(v, &p->root, sizeof(lept_value));
+		lept_init(&p->root);
+	}
+	lept_push_reset(p);
+	return ret;
+}
 
-	case '[':  return lept_parse_array(c, v);
+//字符串生成器 传入lept_context 字符串   字符串长度
+//用解析时的 lept_scan_string() 找出下一个需要转义的字符('"'  '\\'  控制字符)  中间的普通字符一次性复制
+//只有真的遇到需要转义的字符时才压入转义序列  不再为每个字符预留6倍的空间
+static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
+	static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+	const char* end = s + len, *q;
+	size_t n;
+	char* p;
+	assert(s != NULL);
 
-	case '{':  return lept_parse_object(c, v);
+	//最常见的情况  整个字符串都不需要转义  连同两边的引号一次压入
+	q = lept_scan_string(s, end);
+	if (q == end && len < LEPT_STRINGIFY_STRING_CHUNK * 6) {
+		p = lept_context_push(c, len + 2);
+		p[0] = '"';
+		memcpy(p + 1, s, len);
+		p[len + 1] = '"';
+		return;
+	}
 
-	case '\0': return LEPT_PARSE_EXPECT_VALUE;
+	PUTC(c, '"');
+	while (s != end) {
+		//每次最多压入 LEPT_STRINGIFY_STRING_CHUNK * 6 个字节  流式生成时不会超过缓冲区
+		for (; s != q; s += n) {
+			n = (size_t)(q - s) < LEPT_STRINGIFY_STRING_CHUNK * 6 ? (size_t)(q - s) : LEPT_STRINGIFY_STRING_CHUNK * 6;
+			PUTS(c, s, n);
+		}
 
-	default:   return lept_parse_number(c, v);
+		//连续的需要转义的字符
+		for (; s != end && (*s == '\"' || *s == '\\' || (unsigned char)*s < 0x20); s++) {
+			unsigned char ch = (unsigned char)*s;
+			switch (ch) {
+			case '\"': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = '\"'; break;
+			case '\\': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = '\\'; break;
+			case '\b': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = 'b';  break;
+			case '\f': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = 'f';  break;
+			case '\n': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = 'n';  break;
+			case '\r': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = 'r';  break;
+			case '\t': p = lept_context_push(c, 2); p[0] = '\\'; p[1] = 't';  break;
+			default:
+				p = lept_context_push(c, 6);
+				p[0] = '\\'; p[1] = 'u'; p[2] = '0'; p[3] = '0';
+				p[4] = hex_digits[ch >> 4];	//十六进制的右边第二个字符  向右移4位得到对应的十进制
+				p[5] = hex_digits[ch & 15];  // 15： 0000 0000 0000 1111
+			}
+		}
+		q = lept_scan_string(s, end);
 	}
+	PUTC(c, '"');
 }
 
+//整数生成器  从低位开始每次生成两位数字  查表得到对应的两个字符
+static void lept_stringify_uint64(lept_context* c, lept_uint64 u, int negative) {
+	static const char digits[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+	char buf[21], *p = buf + sizeof(buf);
+	while (u >= 100) {
+		unsigned i = (unsigned)(u % 100) * 2;
+		u /= 100;
+		*--p = digits[i + 1];
+		*--p = digits[i];
+	}
+	if (u >= 10) {
+		*--p = digits[u * 2 + 1];
+		*--p = digits[u * 2];
+	}
+	else
+		*--p = (char)('0' + u);
+	if (negative)
+		*--p = '-';
+	PUTS(c, p, (size_t)(buf + sizeof(buf) - p));
+}
 
-//API函数     解析JSON函数
-int lept_parse(lept_value* v, const char* json) {
-
-	//JSON - text = ws value ws
-
-	lept_context c;
-	int ret;
-	assert(v != NULL);
+//浮点数生成  Grisu2算法(Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", 2010)
+//先求出能被解析回同一个double的区间 [m-, m+]  再用64位整数模拟的浮点数乘上一个10的幂  在区间内生成尽量短的十进制数字
+//结果一定能被解析回原值  例如 0.1 生成 "0.1" 而不是 "%.17g" 的 "0.10000000000000001"
+//Grisu2本身不保证最短  随机的double中约0.08%会多出几位数字(最多4位)  例如 3.026580779629e+17 生成 "3.0265807796289997e+17"
+//所以结果落在端点附近没有把握时  再用精确的解析检验逐位缩短(lept_grisu_shorten)  最终结果是最短的
+//不经过stdio  也不受locale影响
 
-	//初始化stack   并最终释放内存
-	c.json = json;
-	c.stack = NULL;
-	c.size = c.top = 0;
-	lept_init(v);
+//用64位整数模拟的浮点数  值为 f * 2^e
+typedef struct {
+	lept_uint64 f;
+	int e;
+}lept_diy_fp;
+
+static const lept_uint64 lept_pow10_u64[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+	1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+	1000000000000000000ULL, 10000000000000000000ULL
+};
+
+//两个diy_fp相乘  只保留积的高64位(舍入到最近)
+static lept_diy_fp lept_diy_fp_mul(lept_diy_fp a, lept_diy_fp b) {
+	lept_diy_fp r;
+	lept_uint64 hi, lo = lept_umul128(a.f, b.f, &hi);
+	r.f = hi + (lo >> 63);
+	r.e = a.e + b.e + 64;
+	return r;
+}
 
-	//第一个w
-	lept_parse_whitespace(&c);
+//左移使f的最高位为1
+static lept_diy_fp lept_diy_fp_normalize(lept_diy_fp x) {
+	int lz = lept_clz64(x.f);
+	x.f <<= lz;
+	x.e -= lz;
+	return x;
+}
 
-	//value
-	//ret来记录解析结果  如果解析成功就继续
-	if ((ret = lept_parse_value(&c, v)) == LEPT_PARSE_OK)
-	{
+//10^q 的64位近似值  直接取数字解析用的5的幂表的高64位(10^q 和 5^q 规格化之后的尾数相同)
+static lept_diy_fp lept_cached_pow10(int q) {
+	const lept_uint64* pow5 = lept_pow5_128 + 2 * (q - LEPT_POW5_MIN);
+	lept_diy_fp r;
+	r.f = pow5[0] + (pow5[1] >> 63);
+	r.e = ((217706 * q) >> 16) - 63;
+	return r;
+}
 
-		//第二个w
-		lept_parse_whitespace(&c);
+//最后一位数字往下调整  使生成的数字尽量靠近原值w   rest 为生成的数字与上界的距离  wp_w 为上界与w的距离
+static void lept_grisu_round(char* buffer, int len, lept_uint64 delta, lept_uint64 rest, lept_uint64 ten_kappa, lept_uint64 wp_w) {
+	while (rest < wp_w && delta - rest >= ten_kappa &&
+		(rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+		buffer[len - 1]--;
+		rest += ten_kappa;
+	}
+}
 
-		//如果第二个w后边还有数   说明不满足JSON语法  
-		if (*c.json != '\0')
-		{
-			//将数据结果 和 解析结果=null  变为对应的类型
-			v->type = LEPT_NULL;
-			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+//从上界mp开始逐位生成数字  直到剩下的部分小于区间宽度delta  即再多的数字都不需要了
+//mp 的指数在 [-60, -32] 内  整数部分p1能放进32位  小数部分为p2
+//停下时上一位截断得到的数字和它加1都在收缩后的区间外  但离端点不超过乘法误差(2个单位)时可能在真正的区间内
+//这时 *unsure 置1  表示可能还有少一位的结果
+static int lept_grisu_digit_gen(lept_diy_fp w, lept_diy_fp mp, lept_uint64 delta, char* buffer, int* k, int* unsure) {
+	int shift = -mp.e, kappa, len = 0;
+	lept_uint64 one = (lept_uint64)1 << shift, wp_w = mp.f - w.f, p2 = mp.f & (one - 1), rest, ten_kappa, unit;
+	unsigned p1 = (unsigned)(mp.f >> shift), d, div;
+
+	//p1的十进制位数
+	for (kappa = 1; kappa < 10 && p1 >= lept_pow10_u64[kappa]; kappa++);
+	//先生成整数部分
+	while (kappa > 0) {
+		div = (unsigned)lept_pow10_u64[kappa - 1];
+		d = p1 / div;
+		p1 %= div;
+		if (d || len)
+			buffer[len++] = (char)('0' + d);
+		kappa--;
+		rest = ((lept_uint64)p1 << shift) + p2;
+		if (rest <= delta) {
+			*k += kappa;
+			ten_kappa = lept_pow10_u64[kappa] << shift;
+			//上一位剩下的部分是 rest + d * ten_kappa  那一位的单位是 ten_kappa * 10
+			*unsure = len > 1 && (rest + d * ten_kappa - delta <= 2 || (10 - d) * ten_kappa - rest <= 2);
+			lept_grisu_round(buffer, len, delta, rest, ten_kappa, wp_w);
+			return len;
 		}
-
 	}
+	//再生成小数部分  每次乘10取出整数位
+	for (;;) {
+		rest = p2;
+		p2 *= 10;
+		delta *= 10;
+		d = (unsigned)(p2 >> shift);
+		if (d || len)
+			buffer[len++] = (char)('0' + d);
+		p2 &= one - 1;
+		kappa--;
+		if (p2 < delta) {
+			*k += kappa;
+			//上一位的剩余部分 rest 和区间宽度 delta / 10 都以 10^(-kappa-1) 为误差单位
+			unit = -kappa < 20 ? lept_pow10_u64[-kappa - 1] : 0;
+			*unsure = len > 1 && (unit == 0 || rest - delta / 10 <= 2 * unit || one - rest <= 2 * unit);
+			lept_grisu_round(buffer, len, delta, p2, one, -kappa < 20 ? wp_w * lept_pow10_u64[-kappa] : 0);
+			return len;
+		}
+	}
+}
 
-	//释放stack的内存
-	assert(c.top == 0);//加入断言确保所有数据都被弹出
-	free(c.stack);
+//生成正的有限double(二进制表示bits)的十进制数字  返回数字个数  值为 buffer * 10^k
+//*unsure 为1时结果可能不是最短的
+static int lept_grisu2(lept_uint64 bits, char* buffer, int* k, int* unsure) {
+	lept_diy_fp v, mp, mm, c, w, wp, wm;
+	int exp_bits = (int)(bits >> 52), q;
 
-	return ret;
+	if (exp_bits) {
+		v.f = (bits & LEPT_DOUBLE_MANTISSA_MASK) | ((lept_uint64)1 << 52);
+		v.e = exp_bits - 1075;
+	}
+	else {
+		v.f = bits;
+		v.e = -1074;
+	}
+	//区间的上下界是与相邻double的中点  尾数刚好是2的幂时  下面相邻的double离得更近  间隔只有一半
+	mp.f = (v.f << 1) + 1;
+	mp.e = v.e - 1;
+	mp = lept_diy_fp_normalize(mp);
+	if ((bits & LEPT_DOUBLE_MANTISSA_MASK) == 0 && exp_bits > 1) {
+		mm.f = (v.f << 2) - 1;
+		mm.e = v.e - 2;
+	}
+	else {
+		mm.f = (v.f << 1) - 1;
+		mm.e = v.e - 1;
+	}
+	mm.f <<= mm.e - mp.e;
+	mm.e = mp.e;
+
+	//选择10^q  使 mp * 10^q 的指数落在 [-60, -32] 内   q = ceil((-61 - mp.e) * log10(2))  78913 / 2^18 约等于 log10(2)
+	q = -(((mp.e + 61) * 78913) >> 18);
+	c = lept_cached_pow10(q);
+	*k = -q;
+	w = lept_diy_fp_mul(lept_diy_fp_normalize(v), c);
+	wp = lept_diy_fp_mul(mp, c);
+	wm = lept_diy_fp_mul(mm, c);
+	assert(wp.e >= -60 && wp.e <= -32);
+	//乘法各有不超过1的误差  区间两端各收缩1保证生成的数字一定在区间内
+	wm.f++;
+	wp.f--;
+	return lept_grisu_digit_gen(w, wp, wp.f - wm.f, buffer, k, unsure);
 }
 
-//字符串生成器 传入lept_context 字符串   字符串长度
-static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
-	static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-	size_t i, size;
-	char* head, *p;
-	assert(s != NULL);
+//精确地求出 w * 10^q 最接近的double的二进制表示  Eisel-Lemire无法确定时退回到大数算法
+static lept_uint64 lept_decimal_bits(lept_uint64 w, int q) {
+	char buf[32], *p = buf + 20, *end = buf + 20;
+	lept_uint64 bits;
+
+	if (lept_eisel_lemire(w, q, &bits))
+		return bits;
+	//拼成 "we-q" 形式的文本交给大数算法
+	do {
+		*--p = (char)('0' + w % 10);
+		w /= 10;
+	} while (w);
+	*end++ = 'e';
+	if (q < 0) {
+		*end++ = '-';
+		q = -q;
+	}
+	if (q >= 100)
+		*end++ = (char)('0' + q / 100);
+	if (q >= 10)
+		*end++ = (char)('0' + q / 10 % 10);
+	*end++ = (char)('0' + q % 10);
+	return lept_decimal_to_double(p, end);
+}
 
-	//创建栈空间   入栈  此地做了优化   就是直接分配足够大的栈空间    直接添加进去   最后调整top的大小
-	p = head = lept_context_push(c, size = len * 6 + 2); /* "\u00xx..." */
+//Grisu2 为了保证结果在区间内把两端各收缩了1  端点附近更短的结果会被漏掉  只在 lept_grisu2 报告 unsure 时调用
+//每次尝试去掉最后一位(向下或向上取整)  用精确的解析检验是否还能还原成同一个double
+//能还原的十进制数构成一个连续区间  所以只需检查紧挨着的这两个候选
+static int lept_grisu_shorten(lept_uint64 bits, char* buffer, int len, int* k) {
+	lept_uint64 d = 0, t, up;
+	int i;
 
-	*p++ = '"';
-	for (i = 0; i < len; i++) {
-		unsigned char ch = (unsigned char)s[i];
+	for (i = 0; i < len; i++)
+		d = d * 10 + (lept_uint64)(buffer[i] - '0');
+	while (d >= 10) {
+		t = d / 10;
+		up = d % 10 >= 5;  //先试更接近的那个
+		if (lept_decimal_bits(t + up, *k + 1) == bits)
+			d = t + up;
+		else if (lept_decimal_bits(t + !up, *k + 1) == bits)
+			d = t + !up;
+		else
+			break;
+		for (++*k; d % 10 == 0; d /= 10)
+			++*k;
+	}
+	for (len = 1, t = d; t >= 10; t /= 10)
+		len++;
+	for (i = len; i-- > 0; d /= 10)
+		buffer[i] = (char)('0' + d % 10);
+	return len;
+}
 
-		switch (ch) {
-		case '\"': *p++ = '\\'; *p++ = '\"'; break;
-		case '\\': *p++ = '\\'; *p++ = '\\'; break;
-		case '\b': *p++ = '\\'; *p++ = 'b';  break;
-		case '\f': *p++ = '\\'; *p++ = 'f';  break;
-		case '\n': *p++ = '\\'; *p++ = 'n';  break;
-		case '\r': *p++ = '\\'; *p++ = 'r';  break;
-		case '\t': *p++ = '\\'; *p++ = 't';  break;
-		default:
-			if (ch < 0x20) {
-				*p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
-				*p++ = hex_digits[ch >> 4];	//十六进制的右边第二个字符  向右移4位得到对应的十进制
-				*p++ = hex_digits[ch & 15];  // 15： 0000 0000 0000 1111
+//生成double到p  最多写入32个字节  返回结尾的位置
+//格式与 "%.17g" 相同: 十进制指数在 [-4, 17) 内用小数形式  否则用 d.ddde+XX 形式(指数至少两位)
+static char* lept_dtoa(char* p, double n) {
+	char digits[20];
+	int len, k, kk, exp, unsure;
+	lept_uint64 bits;
+
+	memcpy(&bits, &n, sizeof(double));
+	if (bits >> 63)
+		*p++ = '-';
+	bits &= ~((lept_uint64)1 << 63);
+	if (bits == 0)
+		*p++ = '0';
+	else if ((bits >> 52) == LEPT_DOUBLE_EXP_INF) {
+		//JSON不能表示无穷大和NaN  保持与 "%.17g" 相同的输出
+		memcpy(p, bits & LEPT_DOUBLE_MANTISSA_MASK ? "nan" : "inf", 3);
+		p += 3;
+	}
+	else {
+		len = lept_grisu2(bits, digits, &k, &unsure);
+		if (unsure)
+			len = lept_grisu_shorten(bits, digits, len, &k);
+		//kk 为小数点的位置  值为 0.d1d2d3... * 10^kk
+		kk = len + k;
+		if (kk >= -3 && kk <= 17) {
+			if (k >= 0) {
+				//整数  1234e2 -> 123400
+				memcpy(p, digits, len);
+				memset(p + len, '0', k);
+				p += kk;
+			}
+			else if (kk > 0) {
+				//1234e-2 -> 12.34
+				memcpy(p, digits, kk);
+				p[kk] = '.';
+				memcpy(p + kk + 1, digits + kk, len - kk);
+				p += len + 1;
+			}
+			else {
+				//1234e-6 -> 0.001234
+				*p++ = '0';
+				*p++ = '.';
+				memset(p, '0', -kk);
+				memcpy(p - kk, digits, len);
+				p += len - kk;
+			}
+		}
+		else {
+			//1234e30 -> 1.234e+33
+			*p++ = digits[0];
+			if (len > 1) {
+				*p++ = '.';
+				memcpy(p, digits + 1, len - 1);
+				p += len - 1;
+			}
+			*p++ = 'e';
+			exp = kk - 1;
+			if (exp < 0) {
+				*p++ = '-';
+				exp = -exp;
 			}
 			else
-				*p++ = s[i];
+				*p++ = '+';
+			if (exp >= 100) {
+				*p++ = (char)('0' + exp / 100);
+				exp %= 100;
+			}
+			*p++ = (char)('0' + exp / 10);
+			*p++ = (char)('0' + exp % 10);
 		}
 	}
-	*p++ = '"';
-	//开始top为加入的最大值  更新top为实际值
-	c->top -= size - (p - head);
+	return p;
+}
+
+static void lept_stringify_double(lept_context* c, double n) {
+	//最长为 "-0.000" 加17位数字  或 "-d." 加16位数字和 "e-324"
+	char* head = lept_context_push(c, 32);
+	c->top -= 32 - (lept_dtoa(head, n) - head);
 }
 
 //生成器生成功能    传入 临时缓冲区栈  和  解析的值     目的是将解析的值转化为字符串放入栈中
@@ -632,17 +4145,23 @@ static void lept_stringify_value(lept_context* c, const lept_value* v) {
 	case LEPT_TRUE:   PUTS(c, "true", 4); break;
 
 		//数字   
-		//为了简单起见，我们使用 sprintf("%.17g", ...) 来把浮点数转换成文本。
-		//"%.17g" 是足够把双精度浮点转换成可还原的文本。
-	case LEPT_NUMBER: c->top -= 32 - sprintf(lept_context_push(c, 32), "%.17g", v->u.n); break;
+		//整数直接转换成十进制   浮点数用Grisu2生成能还原的最短文本  都直接写进栈  不经过sprintf
+	case LEPT_NUMBER:
+		if (v->flags & LEPT_FLAG_INT64)
+			lept_stringify_uint64(c, v->u.i64 < 0 ? 0 - (lept_uint64)v->u.i64 : (lept_uint64)v->u.i64, v->u.i64 < 0);
+		else if (v->flags & LEPT_FLAG_UINT64)
+			lept_stringify_uint64(c, v->u.u64, 0);
+		else
+			lept_stringify_double(c, v->u.n);
+		break;
 
 		//字符串
-	case LEPT_STRING: lept_stringify_string(c, v->u.s.s, v->u.s.len); break;
+	case LEPT_STRING: lept_stringify_string(c, lept_get_string(v), lept_get_string_length(v)); break;
 
 		//数组
 	case LEPT_ARRAY:
 		PUTC(c, '[');
-		for (i = 0; i < v->u.a.size; i++) {
+		for (i = 0; i < LEPT_A_SIZE(v) && !c->error; i++) {
 			if (i > 0)
 				PUTC(c, ',');
 			//递归生成
@@ -654,7 +4173,7 @@ static void lept_stringify_value(lept_context* c, const lept_value* v) {
 		//对象
 	case LEPT_OBJECT:
 		PUTC(c, '{');
-		for (i = 0; i < v->u.o.size; i++) {
+		for (i = 0; i < LEPT_O_SIZE(v) && !c->error; i++) {
 			if (i > 0)
 				PUTC(c, ',');
 
@@ -682,8 +4201,8 @@ char* lept_stringify(const lept_value* v, size_t* length) {
 	assert(v != NULL);
 
 	//创建栈空间  
+	lept_context_init(&c, NULL, 0);
 	c.stack = (char*)malloc(c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
-	c.top = 0;
 
 	//生成字符串
 	lept_stringify_value(&c, v);
@@ -696,7 +4215,151 @@ char* lept_stringify(const lept_value* v, size_t* length) {
 	return c.stack;
 }
 
+//计算字符串转义后的长度  包括两边的引号
+static size_t lept_stringify_string_length(const char* s, size_t len) {
+	const char* end = s + len;
+	size_t n = len + 2;
+	while ((s = lept_scan_string(s, end)) != end) {
+		unsigned char ch = (unsigned char)*s++;
+		if (ch == '\"' || ch == '\\')
+			n++;
+		else
+			n += (ch == '\b' || ch == '\f' || ch == '\n' || ch == '\r' || ch == '\t') ? 1 : 5;
+	}
+	return n;
+}
+
+//十进制位数
+static size_t lept_uint64_length(lept_uint64 u) {
+	size_t n = 1;
+	for (; u >= 10; u /= 10)
+		n++;
+	return n;
+}
+
+size_t lept_stringify_length(const lept_value* v) {
+	char buf[32];
+	size_t i, n;
+	assert(v != NULL);
+	switch (v->type) {
+	case LEPT_NULL:   return 4;
+	case LEPT_FALSE:  return 5;
+	case LEPT_TRUE:   return 4;
+	case LEPT_NUMBER:
+		if (v->flags & LEPT_FLAG_INT64)
+			return v->u.i64 < 0 ? 1 + lept_uint64_length(0 - (lept_uint64)v->u.i64) : lept_uint64_length((lept_uint64)v->u.i64);
+		if (v->flags & LEPT_FLAG_UINT64)
+			return lept_uint64_length(v->u.u64);
+		return (size_t)(lept_dtoa(buf, v->u.n) - buf);
+	case LEPT_STRING: return lept_stringify_string_length(lept_get_string(v), lept_get_string_length(v));
+	case LEPT_ARRAY:
+		//方括号和 size-1 个逗号
+		n = LEPT_A_SIZE(v) > 0 ? LEPT_A_SIZE(v) + 1 : 2;
+		for (i = 0; i < LEPT_A_SIZE(v); i++)
+			n += lept_stringify_length(&v->u.a.e[i]);
+		return n;
+	case LEPT_OBJECT:
+		//花括号  size-1 个逗号  每个成员一个冒号
+		n = LEPT_O_SIZE(v) > 0 ? 2 * LEPT_O_SIZE(v) + 1 : 2;
+		for (i = 0; i < LEPT_O_SIZE(v); i++)
+			n += lept_stringify_string_length(v->u.o.m[i].k, v->u.o.m[i].klen) + lept_stringify_length(&v->u.o.m[i].v);
+		return n;
+	default: assert(0 && "invalid type"); return 0;
+	}
+}
+
+//生成到调用者的缓冲区时  栈一开始就是 buf  直接在里面生成(buf 比局部数组还小时一开始就用局部数组)
+//压栈时 buf 剩下的空间不够(生成字符串和数字时会多预留一些空间)  第一次 write 时内容已经在 buf 中了  把栈换成局部数组
+//之后每次 write 把局部数组中的内容复制到 buf  放不下时返回错误停止生成
+typedef struct {
+	lept_context* c;
+	char* buf;
+	size_t cap, len;
+	char stack[LEPT_STRINGIFY_STRING_CHUNK * 6 + 64];//比一次压栈的最大长度(转义一段字符串的6倍)大  不会被realloc
+}lept_into_buffer;
+
+static int lept_write_into(void* user, const char* data, size_t len) {
+	lept_into_buffer* b = (lept_into_buffer*)user;
+	if (data == b->buf) {
+		b->len = len;
+		b->c->stack = b->stack;
+		b->c->size = sizeof(b->stack);
+		return 0;
+	}
+	if (len > b->cap - b->len)
+		return -1;
+	memcpy(b->buf + b->len, data, len);
+	b->len += len;
+	return 0;
+}
+
+int lept_stringify_into(const lept_value* v, char* buf, size_t cap, size_t* length) {
+	lept_into_buffer b;
+	lept_context c;
+	assert(v != NULL && (buf != NULL || cap == 0));
+	b.c = &c;
+	b.buf = buf;
+	b.cap = cap;
+	b.len = 0;
+	lept_context_init(&c, NULL, 0);
+	//buf 比一次压栈的最大长度大  第一次 write 之前栈里一定有内容
+	c.stack = cap > sizeof(b.stack) ? buf : b.stack;
+	c.size = cap > sizeof(b.stack) ? cap : sizeof(b.stack);
+	c.write = lept_write_into;
+	c.user = &b;
+	lept_stringify_value(&c, v);
+	lept_context_flush(&c);
+	if (length)
+		*length = c.error ? 0 : b.len;
+	return c.error;
+}
+
+//流式生成  栈就是固定大小的输出缓冲区  满了就交给 write
+int lept_stringify_to(const lept_value* v, lept_write_func write, void* user, size_t buf_size) {
+	lept_context c;
+	assert(v != NULL && write != NULL);
+	lept_context_init(&c, NULL, 0);
+	c.stack = (char*)malloc(c.size = buf_size > 0 ? buf_size : LEPT_STRINGIFY_BUFFER_SIZE);
+	c.write = write;
+	c.user = user;
+	lept_stringify_value(&c, v);
+	lept_context_flush(&c);
+	free(c.stack);
+	return c.error;
+}
+
+static int lept_write_file(void* user, const char* data, size_t len) {
+	return fwrite(data, 1, len, (FILE*)user) == len ? 0 : -1;
+}
+
+//write() 可能只写入一部分  或者被信号中断
+static int lept_write_fd_all(void* user, const char* data, size_t len) {
+	int fd = *(int*)user;
+	while (len > 0) {
+		int n = (int)lept_write_fd(fd, data, len < 0x40000000 ? len : 0x40000000);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		data += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+//FILE* 本身有缓冲区  这里的缓冲区只用来减少 fwrite() 的调用次数
+int lept_stringify_file(const lept_value* v, FILE* fp) {
+	assert(fp != NULL);
+	return lept_stringify_to(v, lept_write_file, fp, 0);
+}
+
+int lept_stringify_fd(const lept_value* v, int fd) {
+	return lept_stringify_to(v, lept_write_fd_all, &fd, 0);
+}
+
 //复制功能   传入两个lept_value
+static void lept_update_object_index(lept_value* v);
+
 void lept_copy(lept_value* dst, const lept_value* src) {
 	assert(src != NULL && dst != NULL && src != dst);
 	switch (src->type) {
@@ -705,18 +4368,19 @@ void lept_copy(lept_value* dst, const lept_value* src) {
 
 		//字符串
 	case LEPT_STRING:
-		lept_set_string(dst, src->u.s.s, src->u.s.len);
+		lept_set_string(dst, lept_get_string(src), lept_get_string_length(src));
 		break;
 
 		//数组
 	case LEPT_ARRAY:
 		/* \todo */
-		lept_set_array(dst, src->u.a.capacity);
-		dst->u.a.size = src->u.a.size;
+		lept_set_array(dst, LEPT_A_SIZE(src));
+		LEPT_A_SIZE(dst) = LEPT_A_SIZE(src);
 
 		//递归进行数组各个值的复制
-		for (i = 0; i < src->u.a.size; i++)
+		for (i = 0; i < LEPT_A_SIZE(src); i++)
 		{
+			lept_init(&dst->u.a.e[i]);
 			lept_copy(&dst->u.a.e[i], &src->u.a.e[i]);
 		}
 		break;
@@ -724,13 +4388,23 @@ void lept_copy(lept_value* dst, const lept_value* src) {
 		//对象
 	case LEPT_OBJECT:
 		/* \todo */
-		lept_set_object(dst, src->u.o.capacity);
-		for (i = 0; i < src->u.o.size; i++)
+		//逐个复制成员(包括重复的键)   共用的键只增加引用计数  其他的键复制到堆上
+		lept_set_object(dst, LEPT_O_SIZE(src));
+		dst->flags = src->flags & LEPT_FLAG_INTERNED;
+		for (i = 0; i < LEPT_O_SIZE(src); i++)
 		{
-			//创建键值对并对键复制  递归复制值
-			lept_copy(lept_set_object_value(dst, src->u.o.m[i].k, src->u.o.m->klen), &src->u.o.m[i].v);
+			if (src->flags & LEPT_FLAG_INTERNED)
+				dst->u.o.m[i].k = lept_key_retain(src->u.o.m[i].k);
+			else {
+				dst->u.o.m[i].k = (char*)malloc(src->u.o.m[i].klen + 1);
+				memcpy(dst->u.o.m[i].k, src->u.o.m[i].k, src->u.o.m[i].klen + 1);
+			}
+			dst->u.o.m[i].klen = src->u.o.m[i].klen;
+			lept_init(&dst->u.o.m[i].v);
+			lept_copy(&dst->u.o.m[i].v, &src->u.o.m[i].v);
 		}
-		dst->u.o.size = src->u.o.size;
+		LEPT_O_SIZE(dst) = LEPT_O_SIZE(src);
+		lept_update_object_index(dst);
 		break;
 
 		//true false null 数字   直接复制type  n
@@ -760,37 +4434,57 @@ void lept_swap(lept_value* lhs, lept_value* rhs) {
 	}
 }
 
+//释放对象的一个键  arena中和原地解析的键不释放  共用的键减少引用计数
+static void lept_free_key(const lept_value* v, char* k) {
+	if (v->flags & LEPT_FLAG_INTERNED)
+		lept_key_release(k);
+	else if (!(v->flags & (LEPT_FLAG_ARENA | LEPT_FLAG_BORROWED)))
+		free(k);
+}
+
 //释放lept_value的内存
+//arena中的内存块不释放   整个子树都在arena中并且没有被修改过(SEALED)时不用遍历
+//原地解析的字符串和键在调用者的缓冲区中(BORROWED)  也不释放
 void lept_free(lept_value* v) {
 	size_t i;
+	int owned;
 	assert(v != NULL);
-	switch (v->type) {
+	owned = !(v->flags & LEPT_FLAG_ARENA);
+	if (!(v->flags & LEPT_FLAG_SEALED)) switch (v->type) {
 
 		//string
 	case LEPT_STRING:
-		free(v->u.s.s);
+		if (owned && !(v->flags & (LEPT_FLAG_BORROWED | LEPT_FLAG_INLINE)))
+			free(v->u.s.s);
 		break;
 
 		//数组
 	case LEPT_ARRAY:
-		for (i = 0; i < v->u.a.size; i++)
+		for (i = 0; i < LEPT_A_SIZE(v); i++)
 			lept_free(&v->u.a.e[i]);
-		free(v->u.a.e);
+		if (owned && v->u.a.e != NULL)
+			free(v->u.a.e - LEPT_ARRAY_HEAD);
 		break;
 
 		//对象
 	case LEPT_OBJECT:
-		for (i = 0; i < v->u.o.size; i++) {
-			free(v->u.o.m[i].k);
+		for (i = 0; i < LEPT_O_SIZE(v); i++) {
+			lept_free_key(v, v->u.o.m[i].k);
 			lept_free(&v->u.o.m[i].v);
 		}
-		free(v->u.o.m);
+		if (owned && (v->flags & LEPT_FLAG_INDEXED))
+			free(LEPT_OBJECT_INDEX(v));
+		if (owned && LEPT_HAS_OBJECT_HEAD(v))
+			free(v->u.o.m - 1);
+		else if (owned)
+			free(v->u.o.m);
 		break;
 
 		//不用free
 	default: break;
 	}
 	v->type = LEPT_NULL;
+	v->flags = 0;
 }
 
 //获取结点的数据类型
@@ -801,6 +4495,13 @@ lept_type lept_get_type(const lept_value* v)
 }
 
 //比较两个lept_vlaue  是否相等
+//整数 n 和 double d 比较   d 是整数并且在 n 的类型的范围内时才转换成整数比较  不把 n 转换成double(超过2^53时会损失精度)
+static int lept_is_equal_integer(const lept_value* n, double d) {
+	if (n->flags & LEPT_FLAG_INT64)
+		return d >= -9223372036854775808.0 && d < 9223372036854775808.0 && (double)(lept_int64)d == d && (lept_int64)d == n->u.i64;
+	return d >= 0.0 && d < 18446744073709551616.0 && (double)(lept_uint64)d == d && (lept_uint64)d == n->u.u64;
+}
+
 int lept_is_equal(const lept_value* lhs, const lept_value* rhs) {
 	//对于 true、false、null 这三种类型，比较类型后便完成比较
 	size_t i;
@@ -813,18 +4514,30 @@ int lept_is_equal(const lept_value* lhs, const lept_value* rhs) {
 
 		//字符串
 	case LEPT_STRING:
-		return lhs->u.s.len == rhs->u.s.len &&
-			memcmp(lhs->u.s.s, rhs->u.s.s, lhs->u.s.len) == 0;
+		return lept_get_string_length(lhs) == lept_get_string_length(rhs) &&
+			memcmp(lept_get_string(lhs), lept_get_string(rhs), lept_get_string_length(lhs)) == 0;
 
 		//数字
 	case LEPT_NUMBER:
+		//两个都是整数时按整数比较  一个是整数时见 lept_is_equal_integer()  都是double时按double比较
+		if ((lhs->flags & LEPT_FLAG_NUMBER) && (rhs->flags & LEPT_FLAG_NUMBER)) {
+			if ((lhs->flags & LEPT_FLAG_INT64) && lhs->u.i64 < 0)
+				return (rhs->flags & LEPT_FLAG_INT64) && lhs->u.i64 == rhs->u.i64;
+			if ((rhs->flags & LEPT_FLAG_INT64) && rhs->u.i64 < 0)
+				return 0;
+			return lhs->u.u64 == rhs->u.u64; //非负的int64和uint64的二进制表示相同
+		}
+		if (lhs->flags & LEPT_FLAG_NUMBER)
+			return lept_is_equal_integer(lhs, rhs->u.n);
+		if (rhs->flags & LEPT_FLAG_NUMBER)
+			return lept_is_equal_integer(rhs, lhs->u.n);
 		return lhs->u.n == rhs->u.n;
 
 		//数组
 	case LEPT_ARRAY:
-		if (lhs->u.a.size != rhs->u.a.size)
+		if (LEPT_A_SIZE(lhs) != LEPT_A_SIZE(rhs))
 			return 0;
-		for (i = 0; i < lhs->u.a.size; i++)
+		for (i = 0; i < LEPT_A_SIZE(lhs); i++)
 			if (!lept_is_equal(&lhs->u.a.e[i], &rhs->u.a.e[i]))
 				return 0;
 		return 1;
@@ -833,9 +4546,9 @@ int lept_is_equal(const lept_value* lhs, const lept_value* rhs) {
 	case LEPT_OBJECT:
 		/* \todo */
 		//概念上对象的键值对是无序的  所以可以简单地利用 lept_find_object_index() 去找出对应的值  然后递归作比较
-		if (lhs->u.o.size != rhs->u.a.size)
+		if (LEPT_O_SIZE(lhs) != LEPT_A_SIZE(rhs))
 			return 0;
-		for (i = 0; i < rhs->u.o.size; i++)
+		for (i = 0; i < LEPT_O_SIZE(rhs); i++)
 		{
 			size_t index = lept_find_object_index(lhs, rhs->u.o.m[i].k, rhs->u.o.m[i].klen);
 			if (index == LEPT_KEY_NOT_EXIST)
@@ -863,10 +4576,14 @@ void lept_set_boolean(lept_value* v, int b) {
 	v->type = b ? LEPT_TRUE : LEPT_FALSE;
 }
 
-//读出数字
+//读出数字  整数会转换成double
 double lept_get_number(const lept_value* v) {
 	//检验数据类型是否为LEPT_NUMBER类型  确保类型的正确
 	assert(v != NULL && v->type == LEPT_NUMBER);
+	if (v->flags & LEPT_FLAG_INT64)
+		return (double)v->u.i64;
+	if (v->flags & LEPT_FLAG_UINT64)
+		return (double)v->u.u64;
 	return v->u.n;
 }
 
@@ -877,33 +4594,100 @@ void lept_set_number(lept_value* v, double n) {
 	v->type = LEPT_NUMBER;
 }
 
+//读出数字的存储方式
+lept_number_type lept_get_number_type(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_NUMBER);
+	if (v->flags & LEPT_FLAG_INT64)
+		return LEPT_NUMBER_INT64;
+	if (v->flags & LEPT_FLAG_UINT64)
+		return LEPT_NUMBER_UINT64;
+	return LEPT_NUMBER_DOUBLE;
+}
+
+//读出有符号64位整数  其他存储方式按C语言的规则转换(double会截断小数部分)
+lept_int64 lept_get_int64(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_NUMBER);
+	if (v->flags & LEPT_FLAG_INT64)
+		return v->u.i64;
+	if (v->flags & LEPT_FLAG_UINT64)
+		return (lept_int64)v->u.u64;
+	return (lept_int64)v->u.n;
+}
+
+//写入有符号64位整数
+void lept_set_int64(lept_value* v, lept_int64 i) {
+	lept_free(v);
+	v->u.i64 = i;
+	v->type = LEPT_NUMBER;
+	v->flags = LEPT_FLAG_INT64;
+}
+
+//读出无符号64位整数
+lept_uint64 lept_get_uint64(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_NUMBER);
+	if (v->flags & LEPT_FLAG_NUMBER)
+		return v->u.u64;
+	return (lept_uint64)v->u.n;
+}
+
+//写入无符号64位整数
+void lept_set_uint64(lept_value* v, lept_uint64 u) {
+	lept_free(v);
+	v->u.u64 = u;
+	v->type = LEPT_NUMBER;
+	v->flags = LEPT_FLAG_UINT64;
+}
+
 //读出字符
 const char* lept_get_string(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.s;
+	return v->flags & LEPT_FLAG_INLINE ? LEPT_INLINE_S(v) : v->u.s.s;
 }
 
 //读出字符长度
 size_t lept_get_string_length(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.len;
+	return v->flags & LEPT_FLAG_INLINE ? LEPT_INLINE_LEN(v) : LEPT_S_LEN(v);
 }
 
 //读入字符串  string空间分配函数   传入  结点  字符串  字符串长度
-void lept_set_string(lept_value* v, const char* s, size_t len) {
+int lept_set_string(lept_value* v, const char* s, size_t len) {
+	lept_value t;
 	assert(v != NULL && (s != NULL || len == 0));
+	if (LEPT_SIZE_TOO_LARGE(len))
+		return -1;
+
+	//先在 t 中生成新的字符串  s 可以指向 v 原来的字符串
+	//短字符串不分配内存
+	if (len <= LEPT_INLINE_STRING_MAX)
+		lept_set_inline_string(&t, s, len);
+	else {
+		t.u.s.s = (char*)malloc(len + 1);
+		memcpy(t.u.s.s, s, len);
+
+		//封 长度 类型
+		t.u.s.s[len] = '\0';
+		LEPT_S_LEN(&t) = len;
+		t.type = LEPT_STRING;
+		t.flags = 0;
+	}
 
 	//在设置这个 v 之前，我们需要先调用 lept_free(v) 去清空 v 可能分配到的内存 因为可能原就有字符串
 	lept_free(v);
+	memcpy(v, &t, sizeof(lept_value));
+	return 0;
+}
 
-	v->u.s.s = (char*)malloc(len + 1);
-
-	memcpy(v->u.s.s, s, len);
-
-	//封 长度 类型
-	v->u.s.s[len] = '\0';
-	v->u.s.len = len;
-	v->type = LEPT_STRING;
+//改变数组/对象内存块的大小  old_size为需要保留的字节数
+//arena中的内存块不能realloc  第一次改变大小时复制到堆上  之后就和普通的值一样
+static void* lept_realloc_block(lept_value* v, void* p, size_t old_size, size_t new_size) {
+	void* ret;
+	if (!(v->flags & LEPT_FLAG_ARENA))
+		return realloc(p, new_size);
+	ret = malloc(new_size);
+	memcpy(ret, p, old_size < new_size ? old_size : new_size);
+	v->flags &= ~(LEPT_FLAG_ARENA | LEPT_FLAG_SEALED);
+	return ret;
 }
 
 //创建数组空间  更新capacity
@@ -911,84 +4695,98 @@ void lept_set_array(lept_value* v, size_t capacity) {
 	assert(v != NULL);
 	lept_free(v);
 	v->type = LEPT_ARRAY;
-	v->u.a.size = 0;
-	v->u.a.capacity = capacity;
-	v->u.a.e = capacity > 0 ? (lept_value*)malloc(capacity * sizeof(lept_value)) : NULL;
+	LEPT_A_SIZE(v) = 0;
+	v->u.a.e = capacity > 0 ? (lept_value*)malloc((capacity + LEPT_ARRAY_HEAD) * sizeof(lept_value)) + LEPT_ARRAY_HEAD : NULL;
+	LEPT_SET_A_CAPACITY(v, capacity);
 }
 
 //得到数组的元素个数
 size_t lept_get_array_size(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	return v->u.a.size;
+	return LEPT_A_SIZE(v);
 }
 
 //得到数组的容量
 size_t lept_get_array_capacity(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	return v->u.a.capacity;
+	return LEPT_A_CAPACITY(v);
+}
+
+//改变数组元素的容量  头部和元素一起realloc
+static void lept_resize_array(lept_value* v, size_t capacity) {
+	lept_value* e = v->u.a.e;
+	if (e != NULL)
+		e = (lept_value*)lept_realloc_block(v, e - LEPT_ARRAY_HEAD, (LEPT_A_SIZE(v) + LEPT_ARRAY_HEAD) * sizeof(lept_value), (capacity + LEPT_ARRAY_HEAD) * sizeof(lept_value));
+	else
+		e = (lept_value*)malloc((capacity + LEPT_ARRAY_HEAD) * sizeof(lept_value));
+	v->u.a.e = e + LEPT_ARRAY_HEAD;
+	LEPT_SET_A_CAPACITY(v, capacity);
 }
 
 //重新定义array的空间
 void lept_reserve_array(lept_value* v, size_t capacity) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	if (v->u.a.capacity < capacity) {
-		v->u.a.capacity = capacity;
-		v->u.a.e = (lept_value*)realloc(v->u.a.e, capacity * sizeof(lept_value));
-	}
+	if (LEPT_A_CAPACITY(v) < capacity)
+		lept_resize_array(v, capacity);
 }
 
 //
 void lept_shrink_array(lept_value* v) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	if (v->u.a.capacity > v->u.a.size) {
-		v->u.a.capacity = v->u.a.size;
-		v->u.a.e = (lept_value*)realloc(v->u.a.e, v->u.a.capacity * sizeof(lept_value));
-	}
+	if (LEPT_A_CAPACITY(v) > LEPT_A_SIZE(v))
+		lept_resize_array(v, LEPT_A_SIZE(v));
 }
 
 void lept_clear_array(lept_value* v) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	lept_erase_array_element(v, 0, v->u.a.size);
+	lept_erase_array_element(v, 0, LEPT_A_SIZE(v));
 }
 
 //得到传入数组下标的元素  返回类型  lept_value*
 lept_value* lept_get_array_element(lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	assert(index < v->u.a.size);
+	assert(index < LEPT_A_SIZE(v));
+	LEPT_UNSEAL(v);
 	return &v->u.a.e[index];
 }
 
 lept_value* lept_pushback_array_element(lept_value* v) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
-	if (v->u.a.size == v->u.a.capacity)
-		lept_reserve_array(v, v->u.a.capacity == 0 ? 1 : v->u.a.capacity * 2);
-	lept_init(&v->u.a.e[v->u.a.size]);
-	return &v->u.a.e[v->u.a.size++];
+	if (LEPT_SIZE_TOO_LARGE((size_t)LEPT_A_SIZE(v) + 1))
+		return NULL;
+	if (LEPT_A_SIZE(v) == LEPT_A_CAPACITY(v))
+		lept_reserve_array(v, LEPT_A_SIZE(v) == 0 ? 1 : LEPT_A_SIZE(v) * 2);
+	LEPT_UNSEAL(v);
+	lept_init(&v->u.a.e[LEPT_A_SIZE(v)]);
+	return &v->u.a.e[LEPT_A_SIZE(v)++];
 }
 
 void lept_popback_array_element(lept_value* v) {
-	assert(v != NULL && v->type == LEPT_ARRAY && v->u.a.size > 0);
-	lept_free(&v->u.a.e[--v->u.a.size]);
+	assert(v != NULL && v->type == LEPT_ARRAY && LEPT_A_SIZE(v) > 0);
+	lept_free(&v->u.a.e[--LEPT_A_SIZE(v)]);
 }
 
 lept_value* lept_insert_array_element(lept_value* v, size_t index) {
-	assert(v != NULL && v->type == LEPT_ARRAY && index <= v->u.a.size);
+	assert(v != NULL && v->type == LEPT_ARRAY && index <= LEPT_A_SIZE(v));
 	/* \todo */
+	if (LEPT_SIZE_TOO_LARGE((size_t)LEPT_A_SIZE(v) + 1))
+		return NULL;
 	//首先确定array大小适否
-	if (v->u.a.size == v->u.a.capacity)
-		lept_reserve_array(v, v->u.a.capacity == 0 ? 1 : v->u.a.capacity * 2);
-	//向后复制空出一个位置
-	memcpy(v->u.a.e + index + 1, v->u.a.e + index, (v->u.a.size - index) * sizeof(lept_value));
+	if (LEPT_A_SIZE(v) == LEPT_A_CAPACITY(v))
+		lept_reserve_array(v, LEPT_A_SIZE(v) == 0 ? 1 : LEPT_A_SIZE(v) * 2);
+	LEPT_UNSEAL(v);
+	//向后复制空出一个位置  前后区间重叠  要用 memmove()
+	memmove(v->u.a.e + index + 1, v->u.a.e + index, (LEPT_A_SIZE(v) - index) * sizeof(lept_value));
 	//更新空出位置的类型   不能free  此时只是改变了值  并没有销毁值
 	lept_init(&v->u.a.e[index]);
 	//更新size
-	v->u.a.size++;
+	LEPT_A_SIZE(v)++;
 	return &v->u.a.e[index];
 }
 
 // 删去在 index 位置开始共 count 个元素（不改容量）
 void lept_erase_array_element(lept_value* v, size_t index, size_t count) {
-	assert(v != NULL && v->type == LEPT_ARRAY && index + count <= v->u.a.size);
+	assert(v != NULL && v->type == LEPT_ARRAY && index + count <= LEPT_A_SIZE(v));
 	/* \todo */
 	if (count == 0)
 		return;
@@ -996,13 +4794,13 @@ void lept_erase_array_element(lept_value* v, size_t index, size_t count) {
 	//首先free要删除的值
 	for (i = index; i < index + count; i++)
 		lept_free(&v->u.a.e[i]);
-	//将后边的复制到删除的空位置
-	memcpy(v->u.a.e + index, v->u.a.e + index + count, (v->u.a.size - index - count) * sizeof(lept_value));
+	//将后边的复制到删除的空位置(区间可能重叠)
+	memmove(v->u.a.e + index, v->u.a.e + index + count, (LEPT_A_SIZE(v) - index - count) * sizeof(lept_value));
 	//更新复制过去的值类型
-	for (i = 1, j = v->u.a.size - 1; i <= count; i++, j--)
+	for (i = 1, j = LEPT_A_SIZE(v) - 1; i <= count; i++, j--)
 		lept_init(&v->u.a.e[j]);
 	//更新size
-	v->u.a.size -= count;
+	LEPT_A_SIZE(v) -= count;
 }
 
 //创建对象objec空间  传入lept_value  capacity   更新capacity
@@ -1010,41 +4808,94 @@ void lept_set_object(lept_value* v, size_t capacity) {
 	assert(v != NULL);
 	lept_free(v);
 	v->type = LEPT_OBJECT;
-	v->u.o.size = 0;
-	v->u.o.capacity = capacity;
-	v->u.o.m = capacity > 0 ? (lept_member*)malloc(capacity * sizeof(lept_member)) : NULL;
+	LEPT_O_SIZE(v) = 0;
+	v->u.o.m = capacity > 0 ? (lept_member*)malloc((capacity + LEPT_OBJECT_HEAD) * sizeof(lept_member)) + LEPT_OBJECT_HEAD : NULL;
+	LEPT_SET_O_CAPACITY(v, capacity);
 }
 
 //得到对象中键值对的数量
 size_t lept_get_object_size(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
-	return v->u.o.size;
+	return LEPT_O_SIZE(v);
 }
 
 //得到对象的容量
 size_t lept_get_object_capacity(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
 	/* \todo */
-	return v->u.o.capacity;
+	return LEPT_O_CAPACITY(v);
+}
+
+//arena中的对象要改变大小或者加入新的键之前  先把所有的键复制到堆上  这样对象的键总是全在arena中或者全在堆上
+//原地解析的对象也一样  键全部复制之后就不再依赖缓冲区
+static void lept_detach_object_keys(lept_value* v) {
+	size_t i;
+	char* k;
+	if (v->flags & (LEPT_FLAG_ARENA | LEPT_FLAG_BORROWED))
+		for (i = 0; i < LEPT_O_SIZE(v); i++) {
+			memcpy(k = (char*)malloc(v->u.o.m[i].klen + 1), v->u.o.m[i].k, v->u.o.m[i].klen + 1);
+			v->u.o.m[i].k = k;
+		}
+	v->flags &= ~LEPT_FLAG_BORROWED;
+}
+
+//改变对象成员数组的容量  有索引时连同前面存放索引指针的位置一起realloc  成员的下标不变  索引仍然有效
+//arena中的对象复制到堆上  丢掉arena中的索引  之后由 lept_update_object_index() 在堆上重新建立
+static void lept_resize_object(lept_value* v, size_t capacity) {
+	lept_detach_object_keys(v);
+	if (v->flags & LEPT_FLAG_ARENA)
+		v->flags &= ~LEPT_FLAG_INDEXED;
+	if (LEPT_HAS_OBJECT_HEAD(v))
+		v->u.o.m = (lept_member*)lept_realloc_block(v, v->u.o.m - 1, (LEPT_O_SIZE(v) + 1) * sizeof(lept_member), (capacity + 1) * sizeof(lept_member)) + 1;
+	else if (v->u.o.m != NULL)
+		v->u.o.m = (lept_member*)lept_realloc_block(v, v->u.o.m, LEPT_O_SIZE(v) * sizeof(lept_member), capacity * sizeof(lept_member));
+	else
+		v->u.o.m = (lept_member*)malloc((capacity + LEPT_OBJECT_HEAD) * sizeof(lept_member)) + LEPT_OBJECT_HEAD;
+	LEPT_SET_O_CAPACITY(v, capacity);
+}
+
+//对象加入最后一个成员之后调用  成员数超过阈值时建立索引  索引的槽不够时重新分配
+static void lept_update_object_index(lept_value* v) {
+	lept_object_index* idx;
+	size_t size = LEPT_O_SIZE(v);
+	if (v->flags & LEPT_FLAG_INDEXED) {
+		idx = LEPT_OBJECT_INDEX(v);
+		if (size * 2 <= idx->mask + 1) {
+			lept_object_index_put(idx, v->u.o.m, size - 1);
+			return;
+		}
+		free(idx);
+	}
+	else {
+		if (size <= LEPT_OBJECT_INDEX_THRESHOLD)
+			return;
+		//在成员数组前面腾出存放索引指针的位置  紧凑布局中已经有头部
+		if (!LEPT_OBJECT_HEAD) {
+			v->u.o.m = (lept_member*)realloc(v->u.o.m, (LEPT_O_CAPACITY(v) + 1) * sizeof(lept_member));
+			memmove(v->u.o.m + 1, v->u.o.m, size * sizeof(lept_member));
+			v->u.o.m++;
+		}
+		v->flags |= LEPT_FLAG_INDEXED;
+	}
+	idx = (lept_object_index*)malloc(LEPT_OBJECT_INDEX_SIZE(lept_object_index_slots(size)));
+	lept_object_index_init(idx, lept_object_index_slots(size));
+	lept_object_index_fill(idx, v->u.o.m, size);
+	LEPT_OBJECT_INDEX(v) = idx;
 }
 
 //检测对象的容量   传入lept_value  和期望值
 void lept_reserve_object(lept_value* v, size_t capacity) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
 	/* \todo */
-	if (v->u.o.capacity < capacity) {
-		v->u.o.capacity = capacity;
-		v->u.o.m = (lept_member*)realloc(v->u.o.m, capacity * sizeof(lept_member));
-	}
+	if (LEPT_O_CAPACITY(v) < capacity)
+		lept_resize_object(v, capacity);
 }
 
 void lept_shrink_object(lept_value* v) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
 	/* \todo */
-	if (v->u.o.capacity > v->u.o.size) {
-		v->u.o.capacity = v->u.o.size;
-		v->u.o.m = (lept_member*)realloc(v->u.o.m, v->u.o.capacity * sizeof(lept_member));
-	}
+	if (LEPT_O_CAPACITY(v) > LEPT_O_SIZE(v))
+		lept_resize_object(v, LEPT_O_SIZE(v));
 }
 
 //清除所有元素（不改容量）
@@ -1052,33 +4903,37 @@ void lept_clear_object(lept_value* v) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
 	/* \todo */
 	size_t i;
-	for (i = 0; i < v->u.o.size; i++)
+	for (i = 0; i < LEPT_O_SIZE(v); i++)
 	{
-		free(v->u.o.m[i].k);
-		v->u.o.m->klen = 0;
-		lept_free(&v->u.o.m->v);
+		lept_free_key(v, v->u.o.m[i].k);
+		v->u.o.m[i].klen = 0;
+		lept_free(&v->u.o.m[i].v);
 	}
-	v->u.o.size = 0;
+	LEPT_O_SIZE(v) = 0;
+	//索引保留  只清空槽  再次加入成员时继续使用
+	if (v->flags & LEPT_FLAG_INDEXED)
+		lept_object_index_fill(LEPT_OBJECT_INDEX(v), v->u.o.m, 0);
 }
 
 //得到对象对应下标的键值  返回字符指针k
 const char* lept_get_object_key(const lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
-	assert(index < v->u.o.size);
+	assert(index < LEPT_O_SIZE(v));
 	return v->u.o.m[index].k;
 }
 
 //得到对象对应下标的键值的长度
 size_t lept_get_object_key_length(const lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
-	assert(index < v->u.o.size);
+	assert(index < LEPT_O_SIZE(v));
 	return v->u.o.m[index].klen;
 }
 
 //得到对象对应下标的值  返回lept_value
 lept_value* lept_get_object_value(lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
-	assert(index < v->u.o.size);
+	assert(index < LEPT_O_SIZE(v));
+	LEPT_UNSEAL(v);
 	return &v->u.o.m[index].v;
 }
 
@@ -1087,8 +4942,12 @@ size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen)
 	size_t i;
 	assert(v != NULL && v->type == LEPT_OBJECT && key != NULL);
 
+	//有索引时用哈希查找
+	if (v->flags & LEPT_FLAG_INDEXED)
+		return lept_object_index_get(LEPT_OBJECT_INDEX(v), v->u.o.m, key, klen);
+
 	//线性查找
-	for (i = 0; i < v->u.o.size; i++)
+	for (i = 0; i < LEPT_O_SIZE(v); i++)
 		if (v->u.o.m[i].klen == klen && memcmp(v->u.o.m[i].k, key, klen) == 0)
 			return i;
 
@@ -1099,7 +4958,109 @@ size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen)
 //查找对象的值  传入lept_value 键值 键值长度  返回键值对应的值 lept_value
 lept_value* lept_find_object_value(lept_value* v, const char* key, size_t klen) {
 	size_t index = lept_find_object_index(v, key, klen);
-	return index != LEPT_KEY_NOT_EXIST ? &v->u.o.m[index].v : NULL;
+	if (index == LEPT_KEY_NOT_EXIST)
+		return NULL;
+	LEPT_UNSEAL(v);
+	return &v->u.o.m[index].v;
+}
+
+//JSON Pointer(RFC 6901)编译后的一段
+typedef struct {
+	const char* k;  //解码 ~0 ~1 之后的键  存放在 lept_path 后面
+	size_t klen;
+	size_t index;   //这一段是合法的数组下标("0" 或者不以0开头的十进制数)时的值  否则为 LEPT_KEY_NOT_EXIST
+	size_t hash;    //键的哈希值  查找有索引的对象时不用再求
+}lept_path_token;
+
+struct lept_path {
+	size_t size;
+	lept_path_token t[1]; //实际分配 size 个  后面紧接着所有的键
+};
+
+//把一段解释成数组下标  不合法或者溢出时返回 LEPT_KEY_NOT_EXIST
+static size_t lept_path_index(const char* s, size_t len) {
+	size_t i, index = 0, d;
+	if (len == 0 || (len > 1 && s[0] == '0'))
+		return LEPT_KEY_NOT_EXIST;
+	for (i = 0; i < len; i++) {
+		if (s[i] < '0' || s[i] > '9')
+			return LEPT_KEY_NOT_EXIST;
+		d = (size_t)(s[i] - '0');
+		if (index > (LEPT_KEY_NOT_EXIST - 1 - d) / 10)
+			return LEPT_KEY_NOT_EXIST;
+		index = index * 10 + d;
+	}
+	return index;
+}
+
+lept_path* lept_path_compile(const char* pointer, size_t len) {
+	const char* s = pointer, *end = pointer + len;
+	size_t n = 0, i;
+	lept_path* p;
+	lept_path_token* t;
+	lept_uint64 key[2];
+	char* k;
+	assert(pointer != NULL);
+	//空串表示整个文档  否则必须以'/'开始
+	if (len > 0 && *pointer != '/')
+		return NULL;
+	for (; s != end; s++)
+		if (*s == '/')
+			n++;
+	p = (lept_path*)malloc(sizeof(lept_path) + (n > 0 ? n - 1 : 0) * sizeof(lept_path_token) + len);
+	p->size = n;
+	k = (char*)(p->t + n);
+	lept_hash_key(key);
+	for (s = pointer, i = 0; i < n; i++) {
+		t = &p->t[i];
+		t->k = k;
+		for (s++; s != end && *s != '/'; s++) {
+			if (*s == '~') {
+				if (s + 1 == end || (s[1] != '0' && s[1] != '1')) {
+					free(p);
+					return NULL;
+				}
+				*k++ = *++s == '0' ? '~' : '/';
+			}
+			else
+				*k++ = *s;
+		}
+		t->klen = (size_t)(k - t->k);
+		t->index = lept_path_index(t->k, t->klen);
+		t->hash = (size_t)lept_siphash(key, t->k, t->klen);
+	}
+	return p;
+}
+
+void lept_path_destroy(lept_path* p) {
+	free(p);
+}
+
+//对象中有重复的键时  和 lept_find_object_index() 一样得到第一个
+lept_value* lept_path_get(const lept_path* p, lept_value* v) {
+	size_t i, j;
+	const lept_path_token* t;
+	assert(p != NULL && v != NULL);
+	for (i = 0; i < p->size; i++) {
+		t = &p->t[i];
+		if (v->type == LEPT_OBJECT) {
+			j = v->flags & LEPT_FLAG_INDEXED ? lept_object_index_get_hashed(LEPT_OBJECT_INDEX(v), v->u.o.m, t->k, t->klen, t->hash) : lept_find_object_index(v, t->k, t->klen);
+			if (j == LEPT_KEY_NOT_EXIST)
+				return NULL;
+			LEPT_UNSEAL(v);
+			v = &v->u.o.m[j].v;
+		}
+		else if (v->type == LEPT_ARRAY) {
+			//"-"(末尾之后的元素)和其他不是下标的段都找不到
+			if (t->index >= LEPT_A_SIZE(v))
+				return NULL;
+			LEPT_UNSEAL(v);
+			v = &v->u.a.e[t->index];
+		}
+		else
+			return NULL;
+	}
+	return v;
 }
 
 //创建键值对空间  传入lept_value  key键  键长度   返回新增键值对的值指针
@@ -1108,34 +5069,56 @@ lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen) {
 	/* \todo */
 	//对应键值已经存在  直接返回值的指针
 	size_t index = lept_find_object_index(v, key, klen);
-	if (index != LEPT_KEY_NOT_EXIST)
+	if (index != LEPT_KEY_NOT_EXIST) {
+		LEPT_UNSEAL(v);
 		return &v->u.o.m[index].v;
+	}
+	return lept_append_object_value(v, key, klen);
+}
+
+//在末尾加入键值对  不检查键是否已经存在(和解析器一样保留重复的键)   返回新增键值对的值指针
+lept_value* lept_append_object_value(lept_value* v, const char* key, size_t klen) {
+	size_t tem;
+	assert(v != NULL && v->type == LEPT_OBJECT && key != NULL);
+	LEPT_UNSEAL(v);
+	if (LEPT_SIZE_TOO_LARGE((size_t)LEPT_O_SIZE(v) + 1))
+		return NULL;
 	//添加键值对  首先确定object的容量适否
-	size_t tem = v->u.o.size;
-	if (v->u.o.size == v->u.o.capacity) {
-		lept_reserve_object(v, v->u.o.capacity == 0 ? 1 : (v->u.o.capacity << 1));
+	tem = LEPT_O_SIZE(v);
+	//arena中的对象即使容量足够也要移到堆上  新的键在堆上分配  见 lept_detach_object_keys()
+	if (LEPT_O_SIZE(v) == LEPT_O_CAPACITY(v) || (v->flags & (LEPT_FLAG_ARENA | LEPT_FLAG_BORROWED))) {
+		lept_reserve_object(v, LEPT_O_CAPACITY(v) == 0 ? 1 : (LEPT_O_CAPACITY(v) << 1));
+	}
+	//共用键的对象  新的键也带引用计数  这样对象的键总是全部带或者全部不带
+	if (v->flags & LEPT_FLAG_INTERNED)
+		v->u.o.m[tem].k = lept_key_new(key, klen);
+	else {
+		v->u.o.m[tem].k = (char *)malloc(klen + 1);
+		memcpy(v->u.o.m[tem].k, key, klen);
+		v->u.o.m[tem].k[klen] = '\0';
 	}
-	v->u.o.m[tem].k = (char *)malloc(klen + 1);
-	memcpy(v->u.o.m[v->u.o.size].k, key, klen);
-	v->u.o.m[tem].k[klen] = '\0';
 	v->u.o.m[tem].klen = klen;
 	lept_init(&v->u.o.m[tem].v);
 	//更新size
-	v->u.o.size++;
+	LEPT_O_SIZE(v)++;
+	lept_update_object_index(v);
 	return &v->u.o.m[tem].v;
 }
 
 //删除给定位置的值
 void lept_remove_object_value(lept_value* v, size_t index) {
-	assert(v != NULL && v->type == LEPT_OBJECT && index < v->u.o.size);
+	assert(v != NULL && v->type == LEPT_OBJECT && index < LEPT_O_SIZE(v));
 	/* \todo */
-	free(v->u.o.m[index].k);
+	lept_free_key(v, v->u.o.m[index].k);
 	lept_free(&v->u.o.m[index].v);
-	memcpy(v->u.o.m + index, v->u.o.m + index + 1, (v->u.o.size - 1 - index) * sizeof(lept_member));
-	--v->u.o.size;
-	v->u.o.m[v->u.o.size].k = NULL;
-	v->u.o.m[v->u.o.size].klen = 0;
-	lept_init(&v->u.o.m[v->u.o.size].v);
+	memmove(v->u.o.m + index, v->u.o.m + index + 1, (LEPT_O_SIZE(v) - 1 - index) * sizeof(lept_member));
+	--LEPT_O_SIZE(v);
+	v->u.o.m[LEPT_O_SIZE(v)].k = NULL;
+	v->u.o.m[LEPT_O_SIZE(v)].klen = 0;
+	lept_init(&v->u.o.m[LEPT_O_SIZE(v)].v);
+	//后面的成员下标都减了1  原地重建索引
+	if (v->flags & LEPT_FLAG_INDEXED)
+		lept_object_index_fill(LEPT_OBJECT_INDEX(v), v->u.o.m, LEPT_O_SIZE(v));
 }
 
 /*         JSON语法子集   使用 RFC7159 中的 ABNF 表示：
@@ -2,6 +2,17 @@
 #define LEPTJSON_H__
 
 #include <stddef.h> /* size_t */
+#include <stdio.h>  /* FILE */
+
+//64λ  VC2010֮ǰû<stdint.h>
+#if defined(_MSC_VER) && _MSC_VER < 1600
+typedef __int64 lept_int64;
+typedef unsigned __int64 lept_uint64;
+#else
+#include <stdint.h> /* int64_t, uint64_t */
+typedef int64_t lept_int64;
+typedef uint64_t lept_uint64;
+#endif
 
 //ʾ 6ݽṹ  null  (bool)true/false  number(һĸʾʽ)  string  object(  ֵ)
 typedef enum
@@ -9,6 +20,12 @@ typedef enum
 	LEPT_NULL, LEPT_FALSE, LEPT_TRUE, LEPT_NUMBER, LEPT_STRING, LEPT_ARRAY, LEPT_OBJECT
 } lept_type;
 
+//ֵĴ洢ʽ  ûСֲָ64λΧڵְ洢  ᶪʧ
+typedef enum
+{
+	LEPT_NUMBER_DOUBLE, LEPT_NUMBER_INT64, LEPT_NUMBER_UINT64
+} lept_number_type;
+
 //ֵ  -1
 #define LEPT_KEY_NOT_EXIST ((size_t)-1)
 
@@ -17,6 +34,10 @@ typedef struct lept_value lept_value;
 typedef struct lept_member lept_member;
 
 //JOSNݽṹ
+//ʱ LEPT_COMPACT_VALUE ʹ16ֽڵĽղ(Ĭϲ64λƽ̨32ֽ)  ʹÿĴͬĶ
+//ղ/Ԫǰ  Ԫظַ unsigned 洢  ַ12ֽ
+// UINT_MAX ʱ LEPT_PARSE_TOO_LARGE   lept_set_string() -1  lept_pushback_array_element() ȷNULL  v 
+#ifndef LEPT_COMPACT_VALUE
 struct lept_value
 {
 	union {//һֵֻһ unionʡڴ
@@ -27,10 +48,40 @@ struct lept_value
 
 		struct { char* s; size_t len; }s;                   /* string: null-terminated string, string length */
 
+		struct { char s[3 * sizeof(size_t) - 1]; unsigned char len; }is; /* string: ֱַӴڽ */
+
 		double n;                                           /* number */
+
+		lept_int64 i64;                                     /* number: LEPT_NUMBER_INT64 */
+
+		lept_uint64 u64;                                    /* number: LEPT_NUMBER_UINT64 */
 	}u;
 	lept_type type; //ʾýݽṹ
+	unsigned char flags; //Ϣ  ֵĴ洢ʽ   ֻڿڲʹ
+};
+#else
+struct lept_value
+{
+	union {
+		struct { lept_member* m; }o;                        /* object: members */
+
+		struct { lept_value*  e; }a;                        /* array:  elements */
+
+		struct { char* s; }s;                               /* string: null-terminated string */
+
+		double n;                                           /* number */
+
+		lept_int64 i64;                                     /* number: LEPT_NUMBER_INT64 */
+
+		lept_uint64 u64;                                    /* number: LEPT_NUMBER_UINT64 */
+	}u;
+	unsigned size;       ///Ԫظ  ַĳ
+	unsigned char tail;  //ַӽĵһֽڿʼ  һֱŵ
+	unsigned char len;   //ַĳ
+	unsigned char type;  //lept_type
+	unsigned char flags;
 };
+#endif
 
 //мֵԵݽṹ
 struct lept_member
@@ -55,15 +106,172 @@ enum   //
 	LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET,//ȱٶŻ
 	LEPT_PARSE_MISS_KEY,//ȱټ
 	LEPT_PARSE_MISS_COLON,//ȱð
-	LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET//ȱٶŻ
+	LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET,//ȱٶŻ
+	LEPT_PARSE_STOPPED,//SAXʱ¼0  ֹͣ
+	LEPT_PARSE_NEED_MORE,//push  ıûн
+	LEPT_PARSE_INVALID_UTF8,//UTF-8Уʱ  ַвϷUTF-8ֽ
+	LEPT_PARSE_TOO_LARGE//ղַȻ/Ԫظ UINT_MAX
 };
 
 //ͱnull  Աظͷ
-#define lept_init(v) do { (v)->type = LEPT_NULL; } while(0)
+#define lept_init(v) do { (v)->type = LEPT_NULL; (v)->flags = 0; } while(0)
 
 int lept_parse(lept_value* v, const char* json);
+int lept_parse_n(lept_value* v, const char* json, size_t len); //json Ҫ'\0'β
+
+//ԭؽ  ַͶļֱ json н('\0'β)  ָ json  ʡȥƺͷ
+//json ݻᱻд(ʧʱҲһ)    v ͷ֮ǰͷŻ޸ json
+int lept_parse_insitu(lept_value* v, char* json, size_t len);
+
+//׶ν  SIMDҳнṹַλ  ٰλý lept_value   ʹ lept_parse_n() ͬ
+//λð̶СĴڷֶ  ıȷڴ   ٶȺ lept_parse_n()   תַܶһЩ
+int lept_parse_two_stage(lept_value* v, const char* json, size_t len);
+
+//SAX¼   lept_value   ÿֵʱöӦĺ  ĵ¼ΪNULL
+//ÿط0ʱ  0ʱ lept_parse_sax() ֹͣ LEPT_PARSE_STOPPED
+//on_string/on_key  s ֻںڼЧ  '\0'β   on_number  n  lept_get_number()/lept_get_int64() ȶȡ
+//on_end_array/on_end_object  count Ԫ/Աĸ   ı﷨ʱ  ֮ǰ¼Ѿ
+typedef struct {
+	int (*on_null)(void* user);
+	int (*on_bool)(void* user, int b);
+	int (*on_number)(void* user, const lept_value* n);
+	int (*on_string)(void* user, const char* s, size_t len);
+	int (*on_start_object)(void* user);
+	int (*on_key)(void* user, const char* s, size_t len);
+	int (*on_end_object)(void* user, size_t count);
+	int (*on_start_array)(void* user);
+	int (*on_end_array)(void* user, size_t count);
+}lept_handler;
+
+int lept_parse_sax(const lept_handler* handler, void* user, const char* json, size_t len);
+
+//ظʹõĽ  ڶν֮䱣ڲջ  ʺСı
+//ÿνջ trim_size(ĬΪ LEPT_PARSER_TRIM_SIZE)ʱС trim_size   reset ͷջ
+typedef struct lept_parser lept_parser;
+
+lept_parser* lept_parser_create(void);
+void lept_parser_destroy(lept_parser* p);
+void lept_parser_reset(lept_parser* p);
+void lept_parser_set_trim_size(lept_parser* p, size_t trim_size);
+
+//lept_parser_set_intern_keys(p, 1) ֮  Ķͬļһüڴ(ĬϹر)
+//ס LEPT_INTERN_MAX_KEYS ͬļ  ν֮һֱ   lept_parser_reset()/lept_parser_destroy() ߹رʱЩ
+//Ķ  lept_free()/lept_remove_object_value() ټü   lept_copy() ƳĶͬļ
+//lept_set_object_value() ¼   üԭӲ  üֵڲͬ߳иƺͷ
+void lept_parser_set_intern_keys(lept_parser* p, int intern_keys);
+
+//lept_parser_set_validate_utf8(p, 1) ֮  ַͼвϷUTF-8(    U+10FFFF  ַ)
+// LEPT_PARSE_INVALID_UTF8   \u תĵĵʹ LEPT_PARSE_INVALID_UNICODE_SURROGATE(ĬϹر  ԭ)
+void lept_parser_set_validate_utf8(lept_parser* p, int validate_utf8);
+int lept_parser_parse(lept_parser* p, lept_value* v, const char* json, size_t len);
+
+//push  ıԷֳδ feed  Ҫƴӳһ   ַ//תԿԽ
+//feed  LEPT_PARSE_NEED_MORE(㻹ûн)  LEPT_PARSE_OK(Ѿ  ֻ֮ǿհ)  ߴ
+//finish ʾı  ɹʱѽƵ v    ʹ lept_parse() ƴıͬ
+//finish ֮Լһı
+typedef struct lept_push_parser lept_push_parser;
+
+lept_push_parser* lept_push_parser_create(void);
+void lept_push_parser_destroy(lept_push_parser* p);
+int lept_push_parser_feed(lept_push_parser* p, const char* chunk, size_t len);
+int lept_push_parser_finish(lept_push_parser* p, lept_value* v);
+
+//ĵ  ַ//󶼴ĵڲarena(ڴ)з  ʱͷ  free
+//еķʺ޸ĺ   ޸ʱ·ڴԶ  ĵʱһͷ
+//ĵеֵ½ĵ֮ǰЧ  Ҫ lept_move()/lept_swap() ĵеַ//Ƶĵ
+typedef struct lept_document lept_document;
+
+lept_document* lept_document_create(void);
+void lept_document_destroy(lept_document* doc);
+int lept_document_parse(lept_document* doc, const char* json);
+int lept_document_parse_n(lept_document* doc, const char* json, size_t len);
+lept_value* lept_document_root(lept_document* doc);
 char* lept_stringify(const lept_value* v, size_t* length);
 
+//ʽ  д buf_size ֽڵĻ(Ϊ0ʱĬϴС)  ˾ͽ write  Ҫıڴ
+//write 0ʾɹ  ط0ʱֹͣ  lept_stringify_to() ֵ   ȫɹʱ0
+//lept_stringify_file()/lept_stringify_fd() дļ  ɹ0  ʧܷ-1
+typedef int (*lept_write_func)(void* user, const char* data, size_t len);
+
+int lept_stringify_to(const lept_value* v, lept_write_func write, void* user, size_t buf_size);
+int lept_stringify_file(const lept_value* v, FILE* fp);
+int lept_stringify_fd(const lept_value* v, int fd);
+
+//lept_stringify_length() ɵıĳ('\0')  ڴ
+//lept_stringify_into() ıдߵ buf  ڴ  Ҳڽβ'\0'   *length Ϊдĳ
+//ɹ0   cap ʱ-1  buf еݲ   lept_stringify_length() õҪĴС
+size_t lept_stringify_length(const lept_value* v);
+int lept_stringify_into(const lept_value* v, char* buf, size_t cap, size_t* length);
+
+//NDJSON(JSON Lines)  ÿһһJSONı   threads ̲߳н(Сڵ0ʱʹCPU)
+//˳ÿǿе callback  line к(1ʼ)  ret һеĽ  ʧʱ v Ϊ LEPT_NULL
+//v ֻڻصڼЧ  Ҫʱ lept_move() ȡ   callback 0ʱֹͣ   LEPT_PARSE_STOPPED
+//ȫд귵 LEPT_PARSE_OK(еĴֻͨ ret )  lept_ndjson_parse_file() ȡʧʱ-1
+typedef int (*lept_ndjson_func)(void* user, size_t line, int ret, lept_value* v);
+
+int lept_ndjson_parse(const char* json, size_t len, int threads, lept_ndjson_func callback, void* user);
+int lept_ndjson_parse_file(FILE* fp, int threads, lept_ndjson_func callback, void* user);
+
+//CPUѡSIMDɨ躯   һνʱԶ  ڶ߳нǰҪһ߳еһ
+void lept_init_dispatch(void);
+
+//ֻıƽĵ  н㰴ıе˳һ64λĿ  ַһ黺
+//е±ʾ  ± lept_tape_root()   /¼˽λ  ֱ
+//ʺ lept_get_*() Ӧ   ±Ԫ/ԱҪǰĽ  ˳ʱ lept_tape_next() ȡһֵܽ
+//һԪ/Ա lept_tape_get_array_element(t, i, 0)/lept_tape_get_object_value(t, i, 0)
+//½֮ԭ±ַָȫʧЧ
+typedef struct lept_tape lept_tape;
+
+lept_tape* lept_tape_create(void);
+void lept_tape_destroy(lept_tape* t);
+int lept_tape_parse(lept_tape* t, const char* json, size_t len);
+size_t lept_tape_root(const lept_tape* t);
+size_t lept_tape_next(const lept_tape* t, size_t i);
+lept_type lept_tape_get_type(const lept_tape* t, size_t i);
+int lept_tape_get_boolean(const lept_tape* t, size_t i);
+double lept_tape_get_number(const lept_tape* t, size_t i);
+lept_number_type lept_tape_get_number_type(const lept_tape* t, size_t i);
+lept_int64 lept_tape_get_int64(const lept_tape* t, size_t i);
+lept_uint64 lept_tape_get_uint64(const lept_tape* t, size_t i);
+const char* lept_tape_get_string(const lept_tape* t, size_t i);
+size_t lept_tape_get_string_length(const lept_tape* t, size_t i);
+size_t lept_tape_get_array_size(const lept_tape* t, size_t i);
+size_t lept_tape_get_array_element(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_get_object_size(const lept_tape* t, size_t i);
+const char* lept_tape_get_object_key(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_get_object_key_length(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_get_object_value(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_find_object_value(const lept_tape* t, size_t i, const char* key, size_t klen);
+
+//  lept_parse_lazy() ֻ﷨¼λ  
+///ʱչԪ/Ա(ֻչõһΪֹ)  Ҫֻźŵƥ  չĽĵ
+// lept_lazy_get_value() ȡ   lept_get_*() ȡ
+//json нĵٻ½֮ǰЧ
+typedef struct lept_lazy lept_lazy;
+typedef struct lept_lazy_value lept_lazy_value;
+
+lept_lazy* lept_lazy_create(void);
+void lept_lazy_destroy(lept_lazy* d);
+int lept_parse_lazy(lept_lazy* d, const char* json, size_t len);
+lept_lazy_value* lept_lazy_root(lept_lazy* d);
+lept_type lept_lazy_get_type(const lept_lazy_value* v);
+const lept_value* lept_lazy_get_value(lept_lazy_value* v);
+size_t lept_lazy_get_array_size(lept_lazy_value* v);
+lept_lazy_value* lept_lazy_get_array_element(lept_lazy_value* v, size_t index);
+size_t lept_lazy_get_object_size(lept_lazy_value* v);
+const char* lept_lazy_get_object_key(lept_lazy_value* v, size_t index);
+size_t lept_lazy_get_object_key_length(lept_lazy_value* v, size_t index);
+lept_lazy_value* lept_lazy_get_object_value(lept_lazy_value* v, size_t index);
+lept_lazy_value* lept_lazy_find_object_value(lept_lazy_value* v, const char* key, size_t klen);
+
+//CBOR(RFC 8949)Ʊ   lept_encode_cbor() صĻҪ free()   length ΪNULLʱ
+// int64/uint64   double ڲʧʱð뾫Ȼ򵥾   ļַǷǺϷUTF-8
+//lept_decode_cbor() ֵ lept_parse() ͬ: ݲ LEPT_PARSE_EXPECT_VALUE  ֵ֧ LEPT_PARSE_INVALID_VALUE
+//ӳļַ LEPT_PARSE_MISS_KEY   滹жݷ LEPT_PARSE_ROOT_NOT_SINGULAR   ʧʱvΪnull
+//JSONܱʾ󷵻 LEPT_PARSE_NUMBER_TOO_BIG  NaN  LEPT_PARSE_INVALID_VALUE   ӳظļ lept_parse() һ
+char* lept_encode_cbor(const lept_value* v, size_t* length);
+int lept_decode_cbor(lept_value* v, const char* data, size_t len);
+
 void lept_copy(lept_value* dst, const lept_value* src);
 void lept_move(lept_value* dst, lept_value* src);
 void lept_swap(lept_value* lhs, lept_value* rhs);
@@ -82,9 +290,17 @@ void lept_set_boolean(lept_value* v, int b);
 double lept_get_number(const lept_value* v);
 void lept_set_number(lept_value* v, double n);
 
+lept_number_type lept_get_number_type(const lept_value* v);
+lept_int64 lept_get_int64(const lept_value* v);
+void lept_set_int64(lept_value* v, lept_int64 i);
+lept_uint64 lept_get_uint64(const lept_value* v);
+void lept_set_uint64(lept_value* v, lept_uint64 u);
+
+//ַ(64λƽ̨ϲ22ֽ)ֱӴڽ  lept_get_string() ؽڲĵַ
+//Խ㱻 lept_move()/lept_swap() ƶ  ڵ/չ֮  ԭȡõָʧЧ
 const char* lept_get_string(const lept_value* v);
 size_t lept_get_string_length(const lept_value* v);
-void lept_set_string(lept_value* v, const char* s, size_t len);
+int lept_set_string(lept_value* v, const char* s, size_t len); //ɹ0
 
 void lept_set_array(lept_value* v, size_t capacity);
 size_t lept_get_array_size(const lept_value* v);
@@ -109,7 +325,18 @@ size_t lept_get_object_key_length(const lept_value* v, size_t index);
 lept_value* lept_get_object_value(lept_value* v, size_t index);
 size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen);
 lept_value* lept_find_object_value(lept_value* v, const char* key, size_t klen);
+
+//JSON Pointer(RFC 6901)   "/a/b/3/c"   lept_path_compile() ָıһ  ֮Զĵֵ
+//ʱÿĹϣֵ  ҳԱ(йϣ)ĶʱٶԼϣ
+//ָ벻Ϸ('/'ʼ  '~'治'0'/'1')ʱNULL   մʾĵ
+//lept_path_get() ҲʱNULL   ޸ p  ͬһ lept_path ڶ߳ͬʱʹ   ظļʱõһ
+typedef struct lept_path lept_path;
+
+lept_path* lept_path_compile(const char* pointer, size_t len);
+void lept_path_destroy(lept_path* p);
+lept_value* lept_path_get(const lept_path* p, lept_value* v);
 lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen);
+lept_value* lept_append_object_value(lept_value* v, const char* key, size_t klen); //еļ  ǼµĳԱ
 void lept_remove_object_value(lept_value* v, size_t index);
 
 #endif /* LEPTJSON_H__ */
@@ -0,0 +1,324 @@
+﻿#include "leptjson.h"
+#include <assert.h>  /* assert() */
+#include <stdlib.h>  /* malloc(), realloc(), free() */
+#include <string.h>  /* memcpy(), memchr() */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>  /* sysconf() */
+#endif
+
+//NDJSON(JSON Lines)  每一行是一个JSON文本
+//输入按行边界切成大约 LEPT_NDJSON_BATCH_SIZE 字节的批次  多个线程各自用一个 lept_parser 解析不同的批次
+//调用者的线程按输入顺序把每一行的结果交给回调函数  同时在解析中的批次最多为线程数的2倍  内存占用有上限
+
+#ifndef LEPT_NDJSON_BATCH_SIZE
+#define LEPT_NDJSON_BATCH_SIZE 262144  //每个批次的大小  过小时线程同步的开销变大
+#endif
+
+#ifdef _WIN32
+typedef HANDLE lept_thread;
+typedef CRITICAL_SECTION lept_mutex;
+typedef CONDITION_VARIABLE lept_cond;
+#define lept_mutex_init(m)      InitializeCriticalSection(m)
+#define lept_mutex_destroy(m)   DeleteCriticalSection(m)
+#define lept_mutex_lock(m)      EnterCriticalSection(m)
+#define lept_mutex_unlock(m)    LeaveCriticalSection(m)
+#define lept_cond_init(c)       InitializeConditionVariable(c)
+#define lept_cond_destroy(c)    ((void)0)
+#define lept_cond_wait(c, m)    SleepConditionVariableCS(c, m, INFINITE)
+#define lept_cond_signal(c)     WakeConditionVariable(c)
+#define lept_cond_broadcast(c)  WakeAllConditionVariable(c)
+#else
+typedef pthread_t lept_thread;
+typedef pthread_mutex_t lept_mutex;
+typedef pthread_cond_t lept_cond;
+#define lept_mutex_init(m)      pthread_mutex_init(m, NULL)
+#define lept_mutex_destroy(m)   pthread_mutex_destroy(m)
+#define lept_mutex_lock(m)      pthread_mutex_lock(m)
+#define lept_mutex_unlock(m)    pthread_mutex_unlock(m)
+#define lept_cond_init(c)       pthread_cond_init(c, NULL)
+#define lept_cond_destroy(c)    pthread_cond_destroy(c)
+#define lept_cond_wait(c, m)    pthread_cond_wait(c, m)
+#define lept_cond_signal(c)     pthread_cond_signal(c)
+#define lept_cond_broadcast(c)  pthread_cond_broadcast(c)
+#endif
+
+//一行的解析结果   line 是在批次中的行号(从0开始)
+typedef struct {
+	size_t line;
+	int ret;
+	lept_value v;
+}lept_ndjson_result;
+
+//一个批次  text 是若干完整的行  从文件读取时指向 buf
+typedef struct {
+	const char* text;
+	size_t len;
+	char* buf;
+	size_t buf_size;
+	lept_ndjson_result* results;
+	size_t count, capacity; //结果的个数(空行没有结果)
+	size_t lines;           //批次中的行数
+	int done;
+}lept_ndjson_batch;
+
+typedef struct {
+	lept_ndjson_batch* batches; //环形队列  第 seq 个批次放在 batches[seq % slots]
+	size_t slots;
+	size_t filled;    //已经放入的批次数
+	size_t taken;     //已经被解析线程取走的批次数
+	int quit;
+	lept_mutex mutex;
+	lept_cond work;   //有新的批次或者要退出
+	lept_cond done;   //有批次解析完成
+}lept_ndjson;
+
+//空白行不交给回调函数
+static int lept_ndjson_blank(const char* p, const char* end) {
+	for (; p != end; p++)
+		if (*p != ' ' && *p != '\t' && *p != '\r')
+			return 0;
+	return 1;
+}
+
+//解析一个批次中的每一行
+static void lept_ndjson_parse_batch(lept_parser* parser, lept_ndjson_batch* b) {
+	const char *p = b->text, *end = b->text + b->len, *q;
+	lept_ndjson_result* r;
+	b->count = b->lines = 0;
+	while (p != end) {
+		if ((q = (const char*)memchr(p, '\n', (size_t)(end - p))) == NULL)
+			q = end;
+		if (!lept_ndjson_blank(p, q)) {
+			if (b->count == b->capacity) {
+				b->capacity = b->capacity ? b->capacity * 2 : 256;
+				b->results = (lept_ndjson_result*)realloc(b->results, b->capacity * sizeof(lept_ndjson_result));
+			}
+			r = &b->results[b->count++];
+			r->line = b->lines;
+			lept_init(&r->v);
+			r->ret = lept_parser_parse(parser, &r->v, p, (size_t)(q - p));
+		}
+		b->lines++;
+		p = q == end ? end : q + 1;
+	}
+}
+
+static void lept_ndjson_work(lept_ndjson* nd) {
+	lept_parser* parser = lept_parser_create();
+	lept_ndjson_batch* b;
+	lept_mutex_lock(&nd->mutex);
+	for (;;) {
+		while (nd->taken == nd->filled && !nd->quit)
+			lept_cond_wait(&nd->work, &nd->mutex);
+		if (nd->taken == nd->filled)
+			break;
+		b = &nd->batches[nd->taken++ % nd->slots];
+		lept_mutex_unlock(&nd->mutex);
+		lept_ndjson_parse_batch(parser, b);
+		lept_mutex_lock(&nd->mutex);
+		b->done = 1;
+		lept_cond_broadcast(&nd->done);
+	}
+	lept_mutex_unlock(&nd->mutex);
+	lept_parser_destroy(parser);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI lept_ndjson_thread(LPVOID nd) {
+	lept_ndjson_work((lept_ndjson*)nd);
+	return 0;
+}
+#else
+static void* lept_ndjson_thread(void* nd) {
+	lept_ndjson_work((lept_ndjson*)nd);
+	return NULL;
+}
+#endif
+
+//线程数小于等于0时使用CPU核数
+static int lept_ndjson_threads(int threads) {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	if (threads > 0)
+		return threads;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n;
+	if (threads > 0)
+		return threads;
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#else
+	return threads > 0 ? threads : 4;
+#endif
+}
+
+//输入的来源  buffer 不为NULL时从内存中切分  否则从 fp 读取
+typedef struct {
+	const char* buffer;
+	size_t len, pos;
+	FILE* fp;
+	char* carry;      //上次读取的最后一行中已经读入的部分
+	size_t carry_len, carry_size;
+	int error;
+}lept_ndjson_source;
+
+//从文件读取下一个批次  结尾不完整的行留到下一次
+static int lept_ndjson_read(lept_ndjson_source* src, lept_ndjson_batch* b) {
+	size_t len, n, last;
+	if (b->buf_size < LEPT_NDJSON_BATCH_SIZE || b->buf_size < src->carry_len * 2) {
+		b->buf_size = src->carry_len * 2 > LEPT_NDJSON_BATCH_SIZE ? src->carry_len * 2 : LEPT_NDJSON_BATCH_SIZE;
+		b->buf = (char*)realloc(b->buf, b->buf_size);
+	}
+	if ((len = src->carry_len) > 0)
+		memcpy(b->buf, src->carry, len);
+	src->carry_len = 0;
+	for (;;) {
+		if (len == b->buf_size)
+			b->buf = (char*)realloc(b->buf, b->buf_size *= 2);
+		n = fread(b->buf + len, 1, b->buf_size - len, src->fp);
+		if (n == 0) {
+			src->error = ferror(src->fp);
+			break;
+		}
+		for (last = len + n; last > len && b->buf[last - 1] != '\n'; last--)
+			;
+		len += n;
+		if (last > len - n) {
+			if (len - last > src->carry_size)
+				src->carry = (char*)realloc(src->carry, src->carry_size = len - last);
+			memcpy(src->carry, b->buf + last, src->carry_len = len - last);
+			len = last;
+			break;
+		}
+	}
+	b->text = b->buf;
+	b->len = len;
+	return len > 0;
+}
+
+//取出下一个批次  没有更多输入时返回0
+static int lept_ndjson_next(lept_ndjson_source* src, lept_ndjson_batch* b) {
+	const char* p;
+	size_t n;
+	if (!src->buffer)
+		return lept_ndjson_read(src, b);
+	if (src->pos == src->len)
+		return 0;
+	n = src->len - src->pos;
+	if (n > LEPT_NDJSON_BATCH_SIZE) {
+		p = (const char*)memchr(src->buffer + src->pos + LEPT_NDJSON_BATCH_SIZE, '\n', n - LEPT_NDJSON_BATCH_SIZE);
+		if (p)
+			n = (size_t)(p + 1 - (src->buffer + src->pos));
+	}
+	b->text = src->buffer + src->pos;
+	b->len = n;
+	src->pos += n;
+	return 1;
+}
+
+static int lept_ndjson_run(lept_ndjson_source* src, int threads, lept_ndjson_func callback, void* user) {
+	lept_ndjson nd;
+	lept_thread* workers;
+	lept_ndjson_batch* b;
+	size_t delivered = 0, line = 1, i;
+	int n = lept_ndjson_threads(threads), t, more = 1, ret = LEPT_PARSE_OK;
+
+	nd.slots = (size_t)n * 2;
+	nd.batches = (lept_ndjson_batch*)calloc(nd.slots, sizeof(lept_ndjson_batch));
+	nd.filled = nd.taken = 0;
+	nd.quit = 0;
+	lept_mutex_init(&nd.mutex);
+	lept_cond_init(&nd.work);
+	lept_cond_init(&nd.done);
+	//各线程第一次解析时不再去写选择SIMD实现的函数指针
+	lept_init_dispatch();
+	workers = (lept_thread*)malloc(n * sizeof(lept_thread));
+	for (t = 0; t < n; t++) {
+#ifdef _WIN32
+		workers[t] = CreateThread(NULL, 0, lept_ndjson_thread, &nd, 0, NULL);
+#else
+		pthread_create(&workers[t], NULL, lept_ndjson_thread, &nd);
+#endif
+	}
+
+	//填满空闲的位置  然后按顺序等待最早的批次完成并交给回调函数
+	//回调函数要求停止之后不再放入新的批次  只释放已经放入的批次的结果
+	while (delivered < nd.filled || more) {
+		while (more && nd.filled - delivered < nd.slots) {
+			b = &nd.batches[nd.filled % nd.slots];
+			if (!(more = lept_ndjson_next(src, b)))
+				break;
+			b->done = 0;
+			lept_mutex_lock(&nd.mutex);
+			nd.filled++;
+			lept_cond_signal(&nd.work);
+			lept_mutex_unlock(&nd.mutex);
+		}
+		if (delivered == nd.filled)
+			break;
+		b = &nd.batches[delivered % nd.slots];
+		lept_mutex_lock(&nd.mutex);
+		while (!b->done)
+			lept_cond_wait(&nd.done, &nd.mutex);
+		lept_mutex_unlock(&nd.mutex);
+		for (i = 0; i < b->count; i++) {
+			if (ret == LEPT_PARSE_OK && !callback(user, line + b->results[i].line, b->results[i].ret, &b->results[i].v)) {
+				ret = LEPT_PARSE_STOPPED;
+				more = 0;
+			}
+			lept_free(&b->results[i].v);
+		}
+		line += b->lines;
+		delivered++;
+	}
+
+	lept_mutex_lock(&nd.mutex);
+	nd.quit = 1;
+	lept_cond_broadcast(&nd.work);
+	lept_mutex_unlock(&nd.mutex);
+	for (t = 0; t < n; t++) {
+#ifdef _WIN32
+		WaitForSingleObject(workers[t], INFINITE);
+		CloseHandle(workers[t]);
+#else
+		pthread_join(workers[t], NULL);
+#endif
+	}
+	free(workers);
+	for (i = 0; i < nd.slots; i++) {
+		free(nd.batches[i].results);
+		free(nd.batches[i].buf);
+	}
+	free(nd.batches);
+	lept_cond_destroy(&nd.done);
+	lept_cond_destroy(&nd.work);
+	lept_mutex_destroy(&nd.mutex);
+	return ret;
+}
+
+//API函数  解析内存中的NDJSON文本
+int lept_ndjson_parse(const char* json, size_t len, int threads, lept_ndjson_func callback, void* user) {
+	lept_ndjson_source src;
+	assert((json != NULL || len == 0) && callback != NULL);
+	memset(&src, 0, sizeof(src));
+	src.buffer = json;
+	src.len = len;
+	return lept_ndjson_run(&src, threads, callback, user);
+}
+
+//API函数  从文件中边读边解析   每次读入一个批次  不需要把整个文件读入内存
+int lept_ndjson_parse_file(FILE* fp, int threads, lept_ndjson_func callback, void* user) {
+	lept_ndjson_source src;
+	int ret;
+	assert(fp != NULL && callback != NULL);
+	memset(&src, 0, sizeof(src));
+	src.fp = fp;
+	ret = lept_ndjson_run(&src, threads, callback, user);
+	free(src.carry);
+	return ret == LEPT_PARSE_OK && src.error ? -1 : ret;
+}
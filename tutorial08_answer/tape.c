@@ -0,0 +1,266 @@
+﻿#include "leptjson.h"
+#include <assert.h>  /* assert() */
+#include <stdlib.h>  /* malloc(), realloc(), free() */
+#include <string.h>  /* memcpy(), memcmp() */
+
+//扁平文档(tape)  所有结点按文本中的顺序存放在一个64位条目的数组中  最高8位是标记  低56位是附加数据
+//null/false/true      1个条目
+//数字                 2个条目  [LEPT_NUMBER|存储方式] [double/int64/uint64 的二进制]
+//字符串/键            2个条目  [LEPT_STRING|在字符串缓冲区中的偏移] [长度]   缓冲区中的字符串以'\0'结尾
+//数组/对象            [LEPT_ARRAY|结束条目之后的下标] [元素个数]  元素(对象是键和值交替)  [LEPT_TAPE_END|开始条目的下标]
+//用SAX解析建立  条目数组和字符串缓冲区在多次解析之间重复使用
+
+#define LEPT_TAPE_END           7
+#define LEPT_TAPE_ENTRY(tag, x) (((lept_uint64)(tag) << 56) | (lept_uint64)(x))
+#define LEPT_TAPE_TAG(e)        ((int)((e) >> 56))
+#define LEPT_TAPE_PAYLOAD(e)    ((size_t)((e) & (((lept_uint64)1 << 56) - 1)))
+
+struct lept_tape {
+	lept_uint64* e;
+	size_t size, capacity;
+	char* s;               //字符串缓冲区
+	size_t slen, scapacity;
+	size_t* open;          //解析时还没有结束的数组/对象的开始条目的下标
+	size_t depth, open_capacity;
+};
+
+static lept_uint64* lept_tape_push(lept_tape* t, size_t n) {
+	if (t->size + n > t->capacity) {
+		while (t->size + n > t->capacity)
+			t->capacity = t->capacity ? t->capacity + (t->capacity >> 1) : 256;
+		t->e = (lept_uint64*)realloc(t->e, t->capacity * sizeof(lept_uint64));
+	}
+	t->size += n;
+	return t->e + t->size - n;
+}
+
+static int lept_tape_on_null(void* user) {
+	*lept_tape_push((lept_tape*)user, 1) = LEPT_TAPE_ENTRY(LEPT_NULL, 0);
+	return 1;
+}
+
+static int lept_tape_on_bool(void* user, int b) {
+	*lept_tape_push((lept_tape*)user, 1) = LEPT_TAPE_ENTRY(b ? LEPT_TRUE : LEPT_FALSE, 0);
+	return 1;
+}
+
+static int lept_tape_on_number(void* user, const lept_value* n) {
+	lept_uint64* e = lept_tape_push((lept_tape*)user, 2);
+	lept_number_type type = lept_get_number_type(n);
+	double d;
+	e[0] = LEPT_TAPE_ENTRY(LEPT_NUMBER, type);
+	if (type == LEPT_NUMBER_DOUBLE) {
+		d = lept_get_number(n);
+		memcpy(&e[1], &d, sizeof(d));
+	}
+	else
+		e[1] = lept_get_uint64(n);
+	return 1;
+}
+
+static int lept_tape_on_string(void* user, const char* s, size_t len) {
+	lept_tape* t = (lept_tape*)user;
+	lept_uint64* e = lept_tape_push(t, 2);
+	if (t->slen + len + 1 > t->scapacity) {
+		while (t->slen + len + 1 > t->scapacity)
+			t->scapacity = t->scapacity ? t->scapacity + (t->scapacity >> 1) : 256;
+		t->s = (char*)realloc(t->s, t->scapacity);
+	}
+	e[0] = LEPT_TAPE_ENTRY(LEPT_STRING, t->slen);
+	e[1] = len;
+	if (len > 0)
+		memcpy(t->s + t->slen, s, len);
+	t->s[t->slen + len] = '\0';
+	t->slen += len + 1;
+	return 1;
+}
+
+//开始条目先只写入类型  结束时再填入结束条目的下标和元素个数
+static int lept_tape_on_start(lept_tape* t, lept_type type) {
+	if (t->depth == t->open_capacity) {
+		t->open_capacity = t->open_capacity ? t->open_capacity * 2 : 32;
+		t->open = (size_t*)realloc(t->open, t->open_capacity * sizeof(size_t));
+	}
+	t->open[t->depth++] = t->size;
+	*lept_tape_push(t, 2) = LEPT_TAPE_ENTRY(type, 0);
+	return 1;
+}
+
+static int lept_tape_on_end(lept_tape* t, lept_type type, size_t count) {
+	size_t start = t->open[--t->depth];
+	*lept_tape_push(t, 1) = LEPT_TAPE_ENTRY(LEPT_TAPE_END, start);
+	t->e[start] = LEPT_TAPE_ENTRY(type, t->size);
+	t->e[start + 1] = count;
+	return 1;
+}
+
+static int lept_tape_on_start_array(void* user) {
+	return lept_tape_on_start((lept_tape*)user, LEPT_ARRAY);
+}
+
+static int lept_tape_on_end_array(void* user, size_t count) {
+	return lept_tape_on_end((lept_tape*)user, LEPT_ARRAY, count);
+}
+
+static int lept_tape_on_start_object(void* user) {
+	return lept_tape_on_start((lept_tape*)user, LEPT_OBJECT);
+}
+
+static int lept_tape_on_end_object(void* user, size_t count) {
+	return lept_tape_on_end((lept_tape*)user, LEPT_OBJECT, count);
+}
+
+static const lept_handler lept_tape_handler = {
+	lept_tape_on_null, lept_tape_on_bool, lept_tape_on_number, lept_tape_on_string,
+	lept_tape_on_start_object, lept_tape_on_string, lept_tape_on_end_object,
+	lept_tape_on_start_array, lept_tape_on_end_array
+};
+
+//创建空的扁平文档  根结点为null
+lept_tape* lept_tape_create(void) {
+	lept_tape* t = (lept_tape*)malloc(sizeof(lept_tape));
+	t->e = NULL;
+	t->size = t->capacity = 0;
+	t->s = NULL;
+	t->slen = t->scapacity = 0;
+	t->open = NULL;
+	t->depth = t->open_capacity = 0;
+	lept_tape_on_null(t);
+	return t;
+}
+
+void lept_tape_destroy(lept_tape* t) {
+	assert(t != NULL);
+	free(t->e);
+	free(t->s);
+	free(t->open);
+	free(t);
+}
+
+//API函数  解析长度为len的JSON文本到扁平文档中  原来的内容被覆盖   错误码和 lept_parse_n() 相同  失败时根结点为null
+int lept_tape_parse(lept_tape* t, const char* json, size_t len) {
+	int ret;
+	assert(t != NULL);
+	t->size = t->slen = t->depth = 0;
+	if ((ret = lept_parse_sax(&lept_tape_handler, t, json, len)) != LEPT_PARSE_OK) {
+		t->size = t->slen = t->depth = 0;
+		lept_tape_on_null(t);
+	}
+	return ret;
+}
+
+//根结点的下标
+size_t lept_tape_root(const lept_tape* t) {
+	assert(t != NULL);
+	return 0;
+}
+
+//下标为i的结点之后的结点(兄弟结点或者父结点的结束条目)的下标   数组/对象直接跳过整个子树
+size_t lept_tape_next(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size);
+	switch (LEPT_TAPE_TAG(t->e[i])) {
+	case LEPT_NUMBER:
+	case LEPT_STRING: return i + 2;
+	case LEPT_ARRAY:
+	case LEPT_OBJECT: return LEPT_TAPE_PAYLOAD(t->e[i]);
+	default:          return i + 1;
+	}
+}
+
+lept_type lept_tape_get_type(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) != LEPT_TAPE_END);
+	return (lept_type)LEPT_TAPE_TAG(t->e[i]);
+}
+
+int lept_tape_get_boolean(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && (LEPT_TAPE_TAG(t->e[i]) == LEPT_TRUE || LEPT_TAPE_TAG(t->e[i]) == LEPT_FALSE));
+	return LEPT_TAPE_TAG(t->e[i]) == LEPT_TRUE;
+}
+
+//数字的转换规则和 lept_get_number()/lept_get_int64()/lept_get_uint64() 相同
+double lept_tape_get_number(const lept_tape* t, size_t i) {
+	double d;
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_NUMBER);
+	switch ((lept_number_type)LEPT_TAPE_PAYLOAD(t->e[i])) {
+	case LEPT_NUMBER_INT64:  return (double)(lept_int64)t->e[i + 1];
+	case LEPT_NUMBER_UINT64: return (double)t->e[i + 1];
+	default:
+		memcpy(&d, &t->e[i + 1], sizeof(d));
+		return d;
+	}
+}
+
+lept_number_type lept_tape_get_number_type(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_NUMBER);
+	return (lept_number_type)LEPT_TAPE_PAYLOAD(t->e[i]);
+}
+
+lept_int64 lept_tape_get_int64(const lept_tape* t, size_t i) {
+	if (lept_tape_get_number_type(t, i) != LEPT_NUMBER_DOUBLE)
+		return (lept_int64)t->e[i + 1];
+	return (lept_int64)lept_tape_get_number(t, i);
+}
+
+lept_uint64 lept_tape_get_uint64(const lept_tape* t, size_t i) {
+	if (lept_tape_get_number_type(t, i) != LEPT_NUMBER_DOUBLE)
+		return t->e[i + 1];
+	return (lept_uint64)lept_tape_get_number(t, i);
+}
+
+const char* lept_tape_get_string(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_STRING);
+	return t->s + LEPT_TAPE_PAYLOAD(t->e[i]);
+}
+
+size_t lept_tape_get_string_length(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_STRING);
+	return (size_t)t->e[i + 1];
+}
+
+size_t lept_tape_get_array_size(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_ARRAY);
+	return (size_t)t->e[i + 1];
+}
+
+//第index个元素的下标  需要跳过前面的元素  顺序访问所有元素时用 lept_tape_next()
+size_t lept_tape_get_array_element(const lept_tape* t, size_t i, size_t index) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_ARRAY && index < t->e[i + 1]);
+	for (i += 2; index > 0; index--)
+		i = lept_tape_next(t, i);
+	return i;
+}
+
+size_t lept_tape_get_object_size(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_OBJECT);
+	return (size_t)t->e[i + 1];
+}
+
+//第index个成员的键的下标
+static size_t lept_tape_object_key(const lept_tape* t, size_t i, size_t index) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_OBJECT && index < t->e[i + 1]);
+	for (i += 2; index > 0; index--)
+		i = lept_tape_next(t, i + 2);
+	return i;
+}
+
+const char* lept_tape_get_object_key(const lept_tape* t, size_t i, size_t index) {
+	return lept_tape_get_string(t, lept_tape_object_key(t, i, index));
+}
+
+size_t lept_tape_get_object_key_length(const lept_tape* t, size_t i, size_t index) {
+	return lept_tape_get_string_length(t, lept_tape_object_key(t, i, index));
+}
+
+size_t lept_tape_get_object_value(const lept_tape* t, size_t i, size_t index) {
+	return lept_tape_object_key(t, i, index) + 2;
+}
+
+//依次比较每个键  找到时返回值的下标  否则返回 LEPT_KEY_NOT_EXIST
+size_t lept_tape_find_object_value(const lept_tape* t, size_t i, const char* key, size_t klen) {
+	size_t end;
+	assert(t != NULL && i < t->size && LEPT_TAPE_TAG(t->e[i]) == LEPT_OBJECT && (key != NULL || klen == 0));
+	for (end = LEPT_TAPE_PAYLOAD(t->e[i]) - 1, i += 2; i < end; i = lept_tape_next(t, i + 2))
+		if (t->e[i + 1] == klen && memcmp(t->s + LEPT_TAPE_PAYLOAD(t->e[i]), key, klen) == 0)
+			return i + 2;
+	return LEPT_KEY_NOT_EXIST;
+}
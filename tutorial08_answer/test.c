@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "leptjson.h"
 
 static int main_ret = 0;
@@ -47,7 +48,7 @@ static int test_pass = 0;	//ͨ
 //֮ǰ VC 汾ʹ÷Ǳ׼ "%Iu"
 //ˣĴʹȥ VC 
 //array  Ԥֵʵֵ
-#if 1 defined(_MSC_VER)
+#if defined(_MSC_VER)
 #define EXPECT_EQ_SIZE_T(expect, actual) EXPECT_EQ_BASE((expect) == (actual), (size_t)expect, (size_t)actual, "%Iu")
 #else
 #define EXPECT_EQ_SIZE_T(expect, actual) EXPECT_EQ_BASE((expect) == (actual), (size_t)expect, (size_t)actual, "%zu")
@@ -81,6 +82,17 @@ static void test_parse_false() {
 }
 
 
+//׶νĽʹҪ lept_parse_n() ͬ  ÿıټһ
+static void test_two_stage(const char* json, size_t len) {
+	lept_value expect, v;
+	lept_init(&expect);
+	lept_init(&v);
+	EXPECT_EQ_INT(lept_parse_n(&expect, json, len), lept_parse_two_stage(&v, json, len));
+	EXPECT_TRUE(lept_is_equal(&expect, &v));
+	lept_free(&expect);
+	lept_free(&v);
+}
+
 //ʹöеĺظ
 //ͨ  ǷΪԤ  Ƿȷ  õʵֵǷΪԤֵ
 #define TEST_NUMBER(expect, json)\
@@ -91,6 +103,7 @@ static void test_parse_false() {
         EXPECT_EQ_INT(LEPT_NUMBER, lept_get_type(&v));\
         EXPECT_EQ_DOUBLE(expect, lept_get_number(&v));\
         lept_free(&v);\
+        test_two_stage(json, strlen(json));\
     } while(0)
 
 static void test_parse_number() {
@@ -123,6 +136,61 @@ static void test_parse_number() {
 	TEST_NUMBER(-2.2250738585072014e-308, "-2.2250738585072014e-308");
 	TEST_NUMBER(1.7976931348623157e+308, "1.7976931348623157e+308");  /* Max double */
 	TEST_NUMBER(-1.7976931348623157e+308, "-1.7976931348623157e+308");
+
+	/* ·Χ  Ҫȷ */
+	TEST_NUMBER(0.1, "0.1");
+	TEST_NUMBER(1e23, "1e23");
+	TEST_NUMBER(9007199254740992.0, "9007199254740993"); /* 2^53 + 1  ǡһ  뵽ż */
+	TEST_NUMBER(9007199254740994.0, "9007199254740993.0000000000000000000001");
+	TEST_NUMBER(1.2345678901234568e+29, "123456789012345678901234567890");
+	TEST_NUMBER(1.0, "1.00000000000000011102230246251565404236316680908203125"); /* 1 һdoubleм */
+	TEST_NUMBER(1.0000000000000002, "1.00000000000000011102230246251565404236316680908203126");
+	TEST_NUMBER(2.2250738585072011e-308, "2.2250738585072011e-308");
+	TEST_NUMBER(4.9406564584124654e-324, "2.4703282292062328e-324"); /* СǹһԴ */
+	TEST_NUMBER(0.0, "2.4703282292062327e-324");
+	TEST_NUMBER(1e-7, "0.0000001");
+	TEST_NUMBER(0.0, "0e99999999999");
+}
+
+//Ĵ洢ʽ  type Ϊ INT64/UINT64/DOUBLE ֮һ
+//C89û long long  %lld  64λøߵ32λƴ   EXPECT_TRUE Ƚ
+#define U64(hi, lo) (((lept_uint64)(hi) << 32) | (lept_uint64)(lo))
+#define TEST_INT64(type, expect, json)\
+    do {\
+        lept_value v;\
+        lept_init(&v);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));\
+        EXPECT_EQ_INT(LEPT_NUMBER, lept_get_type(&v));\
+        EXPECT_EQ_INT(LEPT_NUMBER_##type, lept_get_number_type(&v));\
+        EXPECT_TRUE((lept_uint64)(expect) == lept_get_uint64(&v));\
+        lept_free(&v);\
+    } while(0)
+
+static void test_parse_int64() {
+	TEST_INT64(INT64, 0, "0");
+	TEST_INT64(INT64, 1, "1");
+	TEST_INT64(INT64, -1, "-1");
+	TEST_INT64(INT64, U64(0x200000, 1), "9007199254740993"); /* 2^53 + 1  double޷ȷʾ */
+	TEST_INT64(INT64, U64(0x7FFFFFFF, 0xFFFFFFFF), "9223372036854775807");
+	TEST_INT64(INT64, U64(0x80000000, 0), "-9223372036854775808");
+	TEST_INT64(UINT64, U64(0x80000000, 0), "9223372036854775808");
+	TEST_INT64(UINT64, U64(0xFFFFFFFF, 0xFFFFFFFF), "18446744073709551615");
+
+	/* С/ָ/ ߳64λΧȻdouble */
+	TEST_INT64(DOUBLE, 1, "1.0");
+	TEST_INT64(DOUBLE, 100, "1e2");
+	TEST_INT64(DOUBLE, 0, "-0");
+	{
+		lept_value v;
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "18446744073709551616"));
+		EXPECT_EQ_INT(LEPT_NUMBER_DOUBLE, lept_get_number_type(&v));
+		EXPECT_EQ_DOUBLE(18446744073709551616.0, lept_get_number(&v));
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "-9223372036854775809"));
+		EXPECT_EQ_INT(LEPT_NUMBER_DOUBLE, lept_get_number_type(&v));
+		EXPECT_EQ_DOUBLE(-9223372036854775808.0, lept_get_number(&v));
+		lept_free(&v);
+	}
 }
 
 #define TEST_STRING(expect, json)\
@@ -133,6 +201,7 @@ static void test_parse_number() {
         EXPECT_EQ_INT(LEPT_STRING, lept_get_type(&v));\
         EXPECT_EQ_STRING(expect, lept_get_string(&v), lept_get_string_length(&v));\
         lept_free(&v);\
+        test_two_stage(json, strlen(json));\
     } while(0)
 
 static void test_parse_string() {
@@ -258,6 +327,7 @@ static void test_parse_object() {
         EXPECT_EQ_INT(error, lept_parse(&v, json));\
         EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));\
         lept_free(&v);\
+        test_two_stage(json, strlen(json));\
     } while(0)
 
 static void test_parse_expect_value() {
@@ -296,6 +366,8 @@ static void test_parse_root_not_singular() {
 static void test_parse_number_too_big() {
 	TEST_PARSE_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1e309");
 	TEST_PARSE_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "-1e309");
+	TEST_PARSE_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1.7976931348623159e308"); /* Ϊ */
+	TEST_PARSE_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1e99999999999");
 }
 
 static void test_parse_miss_quotation_mark() {
@@ -369,14 +441,507 @@ static void test_parse_miss_comma_or_curly_bracket() {
 	TEST_PARSE_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":{}");
 }
 
+//Ŀհ  òͬĳȺʼַSIMD16/32ֽڷֿɨʱĸֱ߽
+static void test_parse_whitespace() {
+	static const char ws[] = " \t\n\r";
+	char json[128];
+	size_t i, n, off;
+	lept_value v;
+
+	for (off = 0; off < 32; off++) {
+		int ok = 1;
+		for (n = 0; n < 80; n++) {
+			char* p = json + off;
+			p[0] = '[';
+			for (i = 0; i < n; i++)
+				p[1 + i] = ws[i % 4];
+			memcpy(p + 1 + n, "1]", 3);
+			lept_init(&v);
+			if (lept_parse(&v, p) != LEPT_PARSE_OK || lept_get_type(&v) != LEPT_ARRAY || lept_get_array_size(&v) != 1)
+				ok = 0;
+			lept_free(&v);
+		}
+		EXPECT_TRUE(ok);
+	}
+
+	memset(json, ' ', 100);
+	json[100] = '\0';
+	TEST_PARSE_ERROR(LEPT_PARSE_EXPECT_VALUE, json);
+	memcpy(json, "null", 4);
+	json[99] = 'x';
+	TEST_PARSE_ERROR(LEPT_PARSE_ROOT_NOT_SINGULAR, json);
+}
+
+//Խϳַ  ַͨᱻθ  ת/ַ/ȱųڲͬλõ
+static void test_parse_long_string() {
+	char json[160], expect[160];
+	size_t i, n, off;
+	lept_value v;
+
+	for (off = 0; off < 32; off++) {
+		int ok = 1;
+		for (n = 0; n < 100; n++) {
+			char* p = json + off;
+			p[0] = '"';
+			for (i = 0; i < n; i++)
+				expect[i] = p[1 + i] = (char)('a' + i % 26);
+			memcpy(p + 1 + n, "\\n!\"", 5);
+			memcpy(expect + n, "\n!", 3);
+			lept_init(&v);
+			if (lept_parse(&v, p) != LEPT_PARSE_OK || lept_get_string_length(&v) != n + 2 ||
+				memcmp(lept_get_string(&v), expect, n + 3) != 0)
+				ok = 0;
+			lept_free(&v);
+
+			p[1 + n] = '\x1F';
+			lept_init(&v);
+			if (lept_parse(&v, p) != LEPT_PARSE_INVALID_STRING_CHAR)
+				ok = 0;
+			p[1 + n] = '\0';
+			if (lept_parse(&v, p) != LEPT_PARSE_MISS_QUOTATION_MARK)
+				ok = 0;
+			lept_free(&v);
+		}
+		EXPECT_TRUE(ok);
+	}
+}
+
+// lept_parse_n  ֻjsonǰlenַ
+//ƵպlenֽڵĻ  ȡԽʱAddressSanitizerܷ
+#define TEST_PARSE_N(error, json, len)\
+    do {\
+        lept_value v;\
+        char* buf = (char*)malloc((len) > 0 ? (len) : 1);\
+        memcpy(buf, json, len);\
+        lept_init(&v);\
+        EXPECT_EQ_INT(error, lept_parse_n(&v, buf, len));\
+        lept_free(&v);\
+        test_two_stage(buf, len);\
+        free(buf);\
+    } while(0)
+
+static void test_parse_n() {
+	static const char half[] = "1.000000000000000111022302462515654042363166809082031251";
+	char json[128];
+	size_t n;
+	lept_value v;
+
+	TEST_PARSE_N(LEPT_PARSE_OK, "[1,2]xyz", 5);
+	TEST_PARSE_N(LEPT_PARSE_OK, "truex", 4);
+	TEST_PARSE_N(LEPT_PARSE_OK, "\"abc\" ", 6);
+	TEST_PARSE_N(LEPT_PARSE_EXPECT_VALUE, "null", 0);
+	TEST_PARSE_N(LEPT_PARSE_EXPECT_VALUE, "   null", 3);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "true", 3);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "-1", 1);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "1.5", 2);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "1.5e10", 4);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "1.5e+10", 5);
+	TEST_PARSE_N(LEPT_PARSE_ROOT_NOT_SINGULAR, "1 \0", 3);
+	TEST_PARSE_N(LEPT_PARSE_MISS_QUOTATION_MARK, "\"abc\"", 4);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_STRING_CHAR, "\"a\0b\"", 5); /* ıе'\0'ǲϷַ  ٱβ */
+	TEST_PARSE_N(LEPT_PARSE_INVALID_STRING_ESCAPE, "\"\\n\"", 2);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_UNICODE_HEX, "\"\\u0041\"", 5);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_UNICODE_SURROGATE, "\"\\uD834\\uDD1E\"", 8);
+	TEST_PARSE_N(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, "[1,2]", 4);
+	TEST_PARSE_N(LEPT_PARSE_MISS_KEY, "{\"a\":1}", 1);
+	TEST_PARSE_N(LEPT_PARSE_MISS_COLON, "{\"a\":1}", 4);
+	TEST_PARSE_N(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":1}", 6);
+
+	/* lenض  ֲܱ */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "123456", 3));
+	EXPECT_EQ_DOUBLE(123.0, lept_get_number(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, half, sizeof(half) - 2)); /* ȥ1ǡ1һdoubleм */
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, half, sizeof(half) - 1));
+	EXPECT_EQ_DOUBLE(1.0000000000000002, lept_get_number(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "\"a\\u0000b\"", 10));
+	EXPECT_EQ_STRING("a\0b", lept_get_string(&v), lept_get_string_length(&v));
+	lept_free(&v);
+
+	/* βհ׺ͳַмĸλ */
+	memcpy(json, "[1", 2);
+	memset(json + 2, ' ', 100);
+	for (n = 2; n < 102; n++)
+		TEST_PARSE_N(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json, n);
+	json[0] = '"';
+	memset(json + 1, 'a', 100);
+	json[101] = '"';
+	for (n = 1; n < 102; n++)
+		TEST_PARSE_N(LEPT_PARSE_MISS_QUOTATION_MARK, json, n);
+	TEST_PARSE_N(LEPT_PARSE_OK, json, 102);
+}
+
+//ԭؽĽҪ lept_parse() ͬ  ƵպlenֽڵĻ
+#define TEST_PARSE_INSITU(json)\
+    do {\
+        lept_value v, expect;\
+        size_t len = strlen(json);\
+        char* buf = (char*)malloc(len);\
+        memcpy(buf, json, len);\
+        lept_init(&v);\
+        lept_init(&expect);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&expect, json));\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&v, buf, len));\
+        EXPECT_TRUE(lept_is_equal(&expect, &v));\
+        lept_free(&v);\
+        lept_free(&expect);\
+        free(buf);\
+    } while(0)
+
+static void test_parse_insitu() {
+	char json[] = "{\"a\\nb\":[\"x\",\"y\\u0000z\"],\"k\":\"\\uD834\\uDD1E\"}";
+	const char* s;
+	lept_value v, *pv;
+	size_t i;
+
+	TEST_PARSE_INSITU("\"\"");
+	TEST_PARSE_INSITU("\"Hello\"");
+	TEST_PARSE_INSITU("\"Hello\\nWorld\"");
+	TEST_PARSE_INSITU("\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"");
+	TEST_PARSE_INSITU("\"\\u0024 \\u00A2 \\u20AC \\uD834\\uDD1E plain text after the escapes\"");
+	TEST_PARSE_INSITU("[\"abc\",[\"\\t\"],{\"x\\u0041\":\"\\u00e9\",\"y\":null}, 1.5, true]");
+	TEST_PARSE_INSITU("{\"a\":1,\"b\":{\"a\":\"c\",\"\":\"\"}}");
+
+	/* ָ򻺳  ÿַ'\0'β */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&v, json, sizeof(json) - 1));
+	EXPECT_TRUE(lept_get_object_key(&v, 0) >= json && lept_get_object_key(&v, 0) < json + sizeof(json));
+	EXPECT_EQ_STRING("a\nb", lept_get_object_key(&v, 0), lept_get_object_key_length(&v, 0));
+	EXPECT_EQ_INT('\0', lept_get_object_key(&v, 0)[3]);
+	pv = lept_get_object_value(&v, 0);
+	s = lept_get_string(lept_get_array_element(pv, 1));
+	EXPECT_TRUE(s >= json && s < json + sizeof(json));
+	EXPECT_EQ_STRING("y\0z", s, lept_get_string_length(lept_get_array_element(pv, 1)));
+	EXPECT_EQ_STRING("\xF0\x9D\x84\x9E", lept_get_string(lept_find_object_value(&v, "k", 1)), 4);
+
+	/* ޸ĺĲڶ  µļʱеļƵ */
+	lept_set_string(lept_get_array_element(pv, 0), "changed", 7);
+	for (i = 0; i < 20; i++) {
+		char key[] = "k0";
+		key[1] += (char)i;
+		lept_set_number(lept_set_object_value(&v, key, 2), (double)i);
+	}
+	memset(json, 'X', sizeof(json));
+	EXPECT_EQ_STRING("a\nb", lept_get_object_key(&v, 0), lept_get_object_key_length(&v, 0));
+	EXPECT_EQ_STRING("changed", lept_get_string(lept_get_array_element(pv = lept_get_object_value(&v, 0), 0)), 7);
+	EXPECT_EQ_SIZE_T(22, lept_get_object_size(&v));
+	lept_free(&v);
+}
+
+//SAX¼¼ı  ֵȽ
+typedef struct {
+	char log[256];
+	size_t len;
+	int stop_after_key; //"stop"֮ĵһ¼0
+}sax_recorder;
+
+static int sax_log(sax_recorder* r, const char* s, size_t len) {
+	if (r->len + len + 1 < sizeof(r->log)) {
+		memcpy(r->log + r->len, s, len);
+		r->log[r->len += len] = '\0';
+	}
+	if (r->stop_after_key == 2)
+		return 0;
+	return 1;
+}
+
+static int sax_on_null(void* user) { return sax_log((sax_recorder*)user, "n ", 2); }
+static int sax_on_bool(void* user, int b) { return sax_log((sax_recorder*)user, b ? "t " : "f ", 2); }
+static int sax_on_number(void* user, const lept_value* n) {
+	char buf[32];
+	sprintf(buf, "%g ", lept_get_number(n));
+	return sax_log((sax_recorder*)user, buf, strlen(buf));
+}
+static int sax_on_string(void* user, const char* s, size_t len) {
+	sax_log((sax_recorder*)user, "s:", 2);
+	sax_log((sax_recorder*)user, s, len);
+	return sax_log((sax_recorder*)user, " ", 1);
+}
+static int sax_on_start_object(void* user) { return sax_log((sax_recorder*)user, "{ ", 2); }
+static int sax_on_key(void* user, const char* s, size_t len) {
+	sax_recorder* r = (sax_recorder*)user;
+	int ret;
+	sax_log(r, "k:", 2);
+	sax_log(r, s, len);
+	ret = sax_log(r, " ", 1);
+	if (r->stop_after_key && len == 4 && memcmp(s, "stop", 4) == 0)
+		r->stop_after_key = 2;
+	return ret;
+}
+static int sax_on_end_object(void* user, size_t count) {
+	char buf[32];
+	sprintf(buf, "}%d ", (int)count);
+	return sax_log((sax_recorder*)user, buf, strlen(buf));
+}
+static int sax_on_start_array(void* user) { return sax_log((sax_recorder*)user, "[ ", 2); }
+static int sax_on_end_array(void* user, size_t count) {
+	char buf[32];
+	sprintf(buf, "]%d ", (int)count);
+	return sax_log((sax_recorder*)user, buf, strlen(buf));
+}
+
+static const lept_handler sax_handler = {
+	sax_on_null, sax_on_bool, sax_on_number, sax_on_string,
+	sax_on_start_object, sax_on_key, sax_on_end_object,
+	sax_on_start_array, sax_on_end_array
+};
+
+#define TEST_SAX(error, expect, json, stop)\
+    do {\
+        sax_recorder r;\
+        r.len = 0;\
+        r.log[0] = '\0';\
+        r.stop_after_key = stop;\
+        EXPECT_EQ_INT(error, lept_parse_sax(&sax_handler, &r, json, strlen(json)));\
+        EXPECT_EQ_STRING(expect, r.log, r.len);\
+    } while(0)
+
+static void test_parse_sax() {
+	static const char* invalid[] = {
+		"", " ", "nul", "?", "[1,]", "[\"a\", nul]", "{\"a\":1,}", "{1:1}", "{\"a\" 1}", "{\"a\":1 \"b\":2}",
+		"[1 2]", "\"abc", "\"\\v\"", "\"\\u12\"", "\"\\uD800\"", "1e309", "null x", "[[[]]"
+	};
+	static const lept_handler empty = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+	lept_value v;
+	size_t i;
+
+	TEST_SAX(LEPT_PARSE_OK, "n ", "null", 0);
+	TEST_SAX(LEPT_PARSE_OK, "s:a\nb ", " \"a\\nb\" ", 0);
+	TEST_SAX(LEPT_PARSE_OK, "[ ]0 ", "[ ]", 0);
+	TEST_SAX(LEPT_PARSE_OK, "{ }0 ", "{ }", 0);
+	TEST_SAX(LEPT_PARSE_OK, "{ k:a [ t f 1.5 ]3 k:b { k:c n }1 k: s: }3 ",
+		"{\"a\":[true,false,1.5],\"b\":{\"c\":null},\"\":\"\"}", 0);
+
+	/* ¼0ֹͣ  Ĵ󲻻ᱻ */
+	TEST_SAX(LEPT_PARSE_STOPPED, "{ k:a 1 k:stop s:x ", "{\"a\":1,\"stop\":\"x\",\"b\":[2,3],\"c\":?}", 1);
+	TEST_SAX(LEPT_PARSE_STOPPED, "[ { k:stop [ ", "[{\"stop\":[1,2]}]", 1);
+
+	/*  lept_parse() ͬ */
+	for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		lept_init(&v);
+		EXPECT_EQ_INT(lept_parse(&v, invalid[i]), lept_parse_sax(&empty, NULL, invalid[i], strlen(invalid[i])));
+		lept_free(&v);
+	}
+}
+
+// json  cut1 cut2 г鴫push  ÿ鸴ƵպôСĻ
+static int push_parse(lept_push_parser* p, lept_value* v, const char* json, size_t cut1, size_t cut2) {
+	size_t len = strlen(json), cuts[4], i;
+	char* buf;
+	cuts[0] = 0;
+	cuts[1] = cut1;
+	cuts[2] = cut2;
+	cuts[3] = len;
+	for (i = 0; i < 3; i++) {
+		buf = (char*)malloc(cuts[i + 1] - cuts[i] + 1);
+		memcpy(buf, json + cuts[i], cuts[i + 1] - cuts[i]);
+		lept_push_parser_feed(p, buf, cuts[i + 1] - cuts[i]);
+		free(buf);
+	}
+	return lept_push_parser_finish(p, v);
+}
+
+#define PUSH_FEED(p, s) lept_push_parser_feed(p, s, strlen(s))
+
+static void test_parse_push() {
+	static const char* samples[] = {
+		"null", "true", "false", "0", "-0.0", "123", "1.5e-10", "-1E+308", "1e309", "12345678901234567890", "0.1234567890123456789012345",
+		"\"\"", "\"Hello\\nWorld\"", "\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"", "\"\\u20AC \\uD834\\uDD1E\"",
+		"[ ]", "{ }", "[ null , false , true , 123 , \"abc\" ]", "[[],[0],[0,1],[0,1,2]]",
+		" { \"n\" : null , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", \"a\" : [ 1, 2, 3 ], \"o\" : { \"1\" : 1, \"2\" : 2 } } ",
+		"", " ", "nul", "?", "+1", "-", "1.", "1e", "0123", "0x0", "1 2", "null x", "[1,]", "[\"a\", nul]", "[1", "[1 2]", "[",
+		"{", "{\"a\"", "{\"a\":", "{\"a\":1", "{\"a\":1,", "{1:1}", "{\"a\" 1}", "{\"a\":1 \"b\":2}", "{\"a\":{\"b\":[1,{\"c\"",
+		"\"abc", "\"\\", "\"\\v\"", "\"\\u12\"", "\"\\u12", "\"\\uD800\"", "\"\\uD800\\u", "\"\\uDBFF\\uE000\"", "\"a\x01\""
+	};
+	lept_push_parser* p = lept_push_parser_create();
+	lept_value expect, v;
+	size_t i, len, cut1, cut2;
+	int ret, ok;
+
+	for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+		len = strlen(samples[i]);
+		lept_init(&expect);
+		ret = lept_parse(&expect, samples[i]);
+		ok = 1;
+		for (cut1 = 0; cut1 <= len; cut1++)
+			for (cut2 = cut1; cut2 <= len; cut2++) {
+				lept_init(&v);
+				if (push_parse(p, &v, samples[i], cut1, cut2) != ret || (ret == LEPT_PARSE_OK && !lept_is_equal(&expect, &v)))
+					ok = 0;
+				lept_free(&v);
+			}
+		EXPECT_TRUE(ok);
+		lept_free(&expect);
+	}
+
+	/* feed ķֵ */
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "[1,"));
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "\"a\\u00"));
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "e9\""));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, PUSH_FEED(p, "] "));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, PUSH_FEED(p, " "));
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_STRING("a\xC3\xA9", lept_get_string(lept_get_array_element(&v, 1)), 3);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "12"));
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "3"));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, PUSH_FEED(p, " "));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, PUSH_FEED(p, "4"));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, PUSH_FEED(p, " "));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	/* û finish ʱûнĲ/ʱͷ */
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "{\"a\":[\"x\",{\"b\":\"y"));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, PUSH_FEED(p, "\",\"c\"}"));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_NEED_MORE, PUSH_FEED(p, "[{\"a\":\"x\",\"b\":[\"y"));
+	lept_push_parser_destroy(p);
+}
+
+//һ׶ÿδ64ֽ  ıǰϲͬĿհ  ת/ַ/ڿ߽ĸλ
+static void test_parse_two_stage() {
+	static const char* samples[] = {
+		"null", "true", "1.5e-10", "\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"", "\"\\u20AC \\uD834\\uDD1E\"",
+		"[ null , false , true , 123 , \"abc\" ]", "[[],[0],[0,1],[0,1,2]]",
+		" { \"n\" : null , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", \"a\" : [ 1, 2, 3 ], \"o\" : { \"1\" : 1, \"2\" : 2 } } ",
+		"{\"a\\\"b\":\"[{,:}]\",\"c\\\\\":[\"\\\\\\\"\"]}", "[1 2]", "[1x]", "[truex]", "{\"a\" 1}", "{\"a\":1 \"b\":2}", "[\"a\"\"b\"]",
+		"1 2", "\"abc", "\"a\x01\"", "[\"a\", nul]", "{1:1}", "[1,]", "\x80", "[1,\x0B 2]"
+	};
+	char json[256], *s;
+	size_t i, k, n, len;
+
+	for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+		for (k = 0; k < 130; k++) {
+			len = strlen(samples[i]);
+			memset(json, k % 3 ? ' ' : '\n', k);
+			memcpy(json + k, samples[i], len);
+			test_two_stage(json, k + len);
+		}
+
+	/* n ķб֮  n Ϊʱת  ַûн */
+	for (n = 0; n < 6; n++)
+		for (k = 0; k < 130; k++) {
+			json[0] = '[';
+			json[1] = '"';
+			memset(json + 2, 'a', k);
+			memset(json + 2 + k, '\\', n);
+			memcpy(json + 2 + k + n, "\" , \"\\\\\" ]", 10);
+			test_two_stage(json, 12 + k + n);
+		}
+
+	/* תַͽŲͬһ */
+	for (k = 0; k < 130; k++) {
+		json[0] = '"';
+		memset(json + 1, 'a', 200);
+		memcpy(json + 1 + k, "\\n", 2);
+		json[201] = '"';
+		test_two_stage(json, 202);
+		json[1 + k] = '\x01';
+		test_two_stage(json, 202);
+	}
+
+	/* ṹַȵһ׶εĴڶܶ */
+	s = (char*)malloc(200000);
+	len = 0;
+	s[len++] = '[';
+	for (i = 0; i < 10000; i++)
+		len += sprintf(s + len, i % 7 ? "\"s%u\"," : "\"s\\t%u\",", (unsigned)i);
+	s[len - 1] = ']';
+	test_two_stage(s, len);
+	s[len - 1000] = '\x01';
+	test_two_stage(s, len);
+	free(s);
+}
+
+/*  k : k 1000ıʱΪ  997ıʱΪ "nul"  Ϊ k */
+typedef struct {
+	size_t line, count, stop;
+	int ok;
+}ndjson_checker;
+
+static int ndjson_check(void* user, size_t line, int ret, lept_value* v) {
+	ndjson_checker* c = (ndjson_checker*)user;
+	do c->line++; while (c->line % 1000 == 0);
+	if (line != c->line)
+		c->ok = 0;
+	else if (line % 997 == 0)
+		c->ok &= ret == LEPT_PARSE_INVALID_VALUE && lept_get_type(v) == LEPT_NULL;
+	else
+		c->ok &= ret == LEPT_PARSE_OK && lept_get_type(v) == LEPT_NUMBER && lept_get_number(v) == (double)line;
+	return ++c->count != c->stop;
+}
+
+static void test_parse_ndjson() {
+	const size_t lines = 100000;
+	char* json = (char*)malloc(lines * 12);
+	size_t len = 0, k;
+	ndjson_checker c;
+	int threads;
+	FILE* fp;
+
+	for (k = 1; k <= lines; k++) {
+		if (k % 1000 == 0)
+			len += sprintf(json + len, k % 2000 ? "\n" : " \t\r\n");
+		else if (k % 997 == 0)
+			len += sprintf(json + len, "nul\n");
+		else
+			len += sprintf(json + len, k % 3 ? "%u\n" : " %u \r\n", (unsigned)k);
+	}
+	len--; /* һûл */
+
+	for (threads = 0; threads <= 4; threads++) {
+		memset(&c, 0, sizeof(c));
+		c.ok = 1;
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_ndjson_parse(json, len, threads, ndjson_check, &c));
+		EXPECT_TRUE(c.ok);
+		EXPECT_EQ_SIZE_T(lines - lines / 1000, c.count);
+	}
+
+	/* ص0ʱֹͣ  ֮ٵ */
+	memset(&c, 0, sizeof(c));
+	c.ok = 1;
+	c.stop = 5000;
+	EXPECT_EQ_INT(LEPT_PARSE_STOPPED, lept_ndjson_parse(json, len, 4, ndjson_check, &c));
+	EXPECT_TRUE(c.ok);
+	EXPECT_EQ_SIZE_T(5000, c.count);
+
+	memset(&c, 0, sizeof(c));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_ndjson_parse(json, 0, 2, ndjson_check, &c));
+	EXPECT_EQ_SIZE_T(0, c.count);
+
+	if ((fp = tmpfile()) != NULL) {
+		fwrite(json, 1, len, fp);
+		rewind(fp);
+		memset(&c, 0, sizeof(c));
+		c.ok = 1;
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_ndjson_parse_file(fp, 3, ndjson_check, &c));
+		EXPECT_TRUE(c.ok);
+		EXPECT_EQ_SIZE_T(lines - lines / 1000, c.count);
+		fclose(fp);
+	}
+	free(json);
+}
+
 static void test_parse() {
 	test_parse_null();
 	test_parse_true();
 	test_parse_false();
 	test_parse_number();
+	test_parse_int64();
 	test_parse_string();
 	test_parse_array();
 	test_parse_object();
+	test_parse_whitespace();
+	test_parse_long_string();
+	test_parse_n();
+	test_parse_insitu();
+	test_parse_sax();
+	test_parse_push();
+	test_parse_two_stage();
+	test_parse_ndjson();
 
 	test_parse_expect_value();
 	test_parse_invalid_value();
@@ -393,6 +958,21 @@ static void test_parse() {
 	test_parse_miss_comma_or_curly_bracket();
 }
 
+//lept_stringify_length()  lept_stringify() ĳͬ  lept_stringify_into() дͬ  һֽھʧ
+static void test_stringify_into(const lept_value* v, const char* json, size_t length) {
+	char* buf = (char*)malloc(length + 1);
+	size_t n = 1;
+	EXPECT_EQ_SIZE_T(length, lept_stringify_length(v));
+	buf[length] = 'x';
+	EXPECT_EQ_INT(0, lept_stringify_into(v, buf, length + 1, &n));
+	EXPECT_EQ_SIZE_T(length, n);
+	EXPECT_TRUE(memcmp(json, buf, length) == 0 && buf[length] == 'x');
+	EXPECT_EQ_INT(0, lept_stringify_into(v, buf, length, &n));
+	EXPECT_EQ_SIZE_T(length, n);
+	EXPECT_EQ_INT(-1, lept_stringify_into(v, buf, length - 1, &n));
+	free(buf);
+}
+
 // json   Ƿֵͬ   ع
 #define TEST_ROUNDTRIP(json)\
     do {\
@@ -403,12 +983,35 @@ static void test_parse() {
         EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));\
         json2 = lept_stringify(&v, &length);\
         EXPECT_EQ_STRING(json, json2, length);\
+        test_stringify_into(&v, json2, length);\
         lept_free(&v);\
         free(json2);\
+        test_two_stage(json, strlen(json));\
+    } while(0)
+
+// lept_set_number дdoubleɽ
+#define TEST_STRINGIFY_NUMBER(expect, n)\
+    do {\
+        lept_value v;\
+        char* json;\
+        size_t length;\
+        lept_init(&v);\
+        lept_set_number(&v, n);\
+        json = lept_stringify(&v, &length);\
+        EXPECT_EQ_STRING(expect, json, length);\
+        lept_free(&v);\
+        free(json);\
     } while(0)
 
 //
 static void test_stringify_number() {
+	lept_value v;
+	lept_uint64 x = U64(0x01394B0C, 0x4E5A1B44), bits;
+	double d;
+	char* json;
+	size_t length;
+	int i;
+
 	TEST_ROUNDTRIP("0");
 	TEST_ROUNDTRIP("-0");
 	TEST_ROUNDTRIP("1");
@@ -421,14 +1024,62 @@ static void test_stringify_number() {
 	TEST_ROUNDTRIP("1.234e-20");
 
 	TEST_ROUNDTRIP("1.0000000000000002"); /* the smallest number > 1 */
-	TEST_ROUNDTRIP("4.9406564584124654e-324"); /* minimum denormal */
-	TEST_ROUNDTRIP("-4.9406564584124654e-324");
-	TEST_ROUNDTRIP("2.2250738585072009e-308");  /* Max subnormal double */
-	TEST_ROUNDTRIP("-2.2250738585072009e-308");
+	TEST_ROUNDTRIP("5e-324"); /* minimum denormal */
+	TEST_ROUNDTRIP("-5e-324");
+	TEST_ROUNDTRIP("2.225073858507201e-308");  /* Max subnormal double */
+	TEST_ROUNDTRIP("-2.225073858507201e-308");
 	TEST_ROUNDTRIP("2.2250738585072014e-308");  /* Min normal positive double */
 	TEST_ROUNDTRIP("-2.2250738585072014e-308");
 	TEST_ROUNDTRIP("1.7976931348623157e+308");  /* Max double */
 	TEST_ROUNDTRIP("-1.7976931348623157e+308");
+
+	/* ܻԭ  ʽ "%.17g" ͬ */
+	TEST_ROUNDTRIP("0.1");
+	TEST_ROUNDTRIP("0.3");
+	TEST_ROUNDTRIP("-123.456");
+	TEST_ROUNDTRIP("0.0001");
+	TEST_ROUNDTRIP("1e-05");
+	TEST_ROUNDTRIP("1.5e-07");
+	TEST_ROUNDTRIP("1e+17");
+	TEST_ROUNDTRIP("1.2345678901234568e+29");
+	TEST_ROUNDTRIP("5.4e-79");
+	TEST_ROUNDTRIP("9.8e+100");
+	TEST_STRINGIFY_NUMBER("0.1", 0.1);
+	TEST_STRINGIFY_NUMBER("10000000000000000", 1e16);
+	TEST_STRINGIFY_NUMBER("100", 1e2);
+	TEST_STRINGIFY_NUMBER("0.30000000000000004", 0.1 + 0.2);
+	TEST_STRINGIFY_NUMBER("9007199254740992", 9007199254740992.0);
+	TEST_STRINGIFY_NUMBER("1.7976931348623157e+308", 1.7976931348623157e+308);
+
+	/* Grisu2 ˵㸽ɼλ  Ҫ̵̳Ľ */
+	TEST_ROUNDTRIP("3.026580779629e+17");
+	TEST_ROUNDTRIP("2.1406127740768e+19");
+	TEST_ROUNDTRIP("6.45460607309759e+258");
+	TEST_ROUNDTRIP("2.718316374298659e+276");
+
+	/* doubleɵıܽͬһֵ */
+	lept_init(&v);
+	for (i = 0; i < 10000; i++) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		bits = x & ~((lept_uint64)1 << 63);
+		if ((bits >> 52) == 0x7FF)
+			continue;
+		memcpy(&d, &bits, sizeof(double));
+		lept_set_number(&v, d);
+		json = lept_stringify(&v, &length);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		EXPECT_EQ_DOUBLE(d, lept_get_number(&v));
+		free(json);
+	}
+	lept_free(&v);
+
+	/* 64λԭ  double */
+	TEST_ROUNDTRIP("9007199254740993");
+	TEST_ROUNDTRIP("9223372036854775807");
+	TEST_ROUNDTRIP("-9223372036854775808");
+	TEST_ROUNDTRIP("18446744073709551615");
 }
 
 //ַ
@@ -453,6 +1104,98 @@ static void test_stringify_object() {
 }
 
 //  7
+//ռ lept_stringify_to()   ¼ÿд󳤶  д fail_at ֮󷵻ش
+typedef struct {
+	char* s;
+	size_t len, max_write;
+	int writes, fail_at;
+}string_writer;
+
+static int string_write(void* user, const char* data, size_t len) {
+	string_writer* w = (string_writer*)user;
+	if (++w->writes == w->fail_at)
+		return 42;
+	w->s = (char*)realloc(w->s, w->len + len);
+	memcpy(w->s + w->len, data, len);
+	w->len += len;
+	if (len > w->max_write)
+		w->max_write = len;
+	return 0;
+}
+
+static void test_stringify_to() {
+	lept_value v, *e;
+	string_writer w;
+	char* json, *s;
+	size_t i, len;
+	FILE* fp;
+
+	/* ַܳͺܶСԪ   lept_stringify() ͬ  ÿд벻С */
+	lept_init(&v);
+	lept_set_array(&v, 0);
+	s = (char*)malloc(100000);
+	for (i = 0; i < 100000; i++)
+		s[i] = (char)(i % 96 + (i % 7 == 0 ? 0 : 32));
+	lept_set_string(lept_pushback_array_element(&v), s, 100000);
+	free(s);
+	for (i = 0; i < 10000; i++) {
+		e = lept_pushback_array_element(&v);
+		lept_set_object(e, 1);
+		lept_set_number(lept_set_object_value(e, "n", 1), i * 0.25);
+	}
+	json = lept_stringify(&v, &len);
+
+	memset(&w, 0, sizeof(w));
+	EXPECT_EQ_INT(0, lept_stringify_to(&v, string_write, &w, 4096));
+	EXPECT_EQ_SIZE_T(len, w.len);
+	EXPECT_TRUE(w.len == len && memcmp(json, w.s, len) == 0);
+	EXPECT_TRUE(w.max_write <= 4096);
+	/* ֺܶд  ÿдǰ */
+	EXPECT_TRUE(w.writes >= (int)(len / 4096) && w.writes <= (int)(len / 2048));
+	free(w.s);
+
+	/* write شֹͣ */
+	memset(&w, 0, sizeof(w));
+	w.fail_at = 3;
+	EXPECT_EQ_INT(42, lept_stringify_to(&v, string_write, &w, 4096));
+	EXPECT_EQ_INT(3, w.writes);
+
+	fp = tmpfile();
+	if (fp) {
+		EXPECT_EQ_INT(0, lept_stringify_file(&v, fp));
+		EXPECT_EQ_SIZE_T(len, (size_t)ftell(fp));
+		rewind(fp);
+		s = (char*)malloc(len);
+		EXPECT_EQ_SIZE_T(len, fread(s, 1, len, fp));
+		EXPECT_TRUE(memcmp(json, s, len) == 0);
+		free(s);
+		fclose(fp);
+	}
+	EXPECT_EQ_INT(-1, lept_stringify_fd(&v, -1));
+	/*  lept_stringify_into() ڲջܶ */
+	test_stringify_into(&v, json, len);
+	free(w.s);
+	free(json);
+	lept_free(&v);
+
+	/* СĻ */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[true,\"abc\",{\"k\":-1.5}]"));
+	json = lept_stringify(&v, &len);
+	for (i = 1; i <= 3; i++) {
+		memset(&w, 0, sizeof(w));
+		EXPECT_EQ_INT(0, lept_stringify_to(&v, string_write, &w, i));
+		EXPECT_TRUE(w.len == len && memcmp(json, w.s, len) == 0);
+		free(w.s);
+		memset(&w, 0, sizeof(w));
+		EXPECT_EQ_INT(0, lept_stringify_to(lept_get_array_element(&v, 0), string_write, &w, i));
+		EXPECT_TRUE(w.len == 4 && memcmp("true", w.s, 4) == 0);
+		free(w.s);
+	}
+	free(json);
+	lept_free(&v);
+}
+
 static void test_stringify() {
 	TEST_ROUNDTRIP("null");
 	TEST_ROUNDTRIP("false");
@@ -461,6 +1204,7 @@ static void test_stringify() {
 	test_stringify_string();
 	test_stringify_array();
 	test_stringify_object();
+	test_stringify_to();
 }
 
 //ع       ֵǷ
@@ -485,6 +1229,19 @@ static void test_equal() {
 	TEST_EQUAL("null", "0", 0);
 	TEST_EQUAL("123", "123", 1);
 	TEST_EQUAL("123", "456", 0);
+	TEST_EQUAL("1", "1.0", 1);
+	TEST_EQUAL("100", "1e2", 1);
+	TEST_EQUAL("9007199254740993", "9007199254740992", 0);
+	TEST_EQUAL("18446744073709551615", "-1", 0);
+	/* doubleȽ  2^53ܰתdouble */
+	TEST_EQUAL("9007199254740993", "9007199254740992.0", 0);
+	TEST_EQUAL("9007199254740992.0", "9007199254740993", 0);
+	TEST_EQUAL("9007199254740992", "9007199254740992.0", 1);
+	TEST_EQUAL("9007199254740993", "9.007199254740993e15", 0);
+	TEST_EQUAL("18446744073709551615", "1.8446744073709551615e19", 0);
+	TEST_EQUAL("-9223372036854775808", "-9.223372036854775808e18", 1);
+	TEST_EQUAL("-9223372036854775807", "-9.223372036854775807e18", 0);
+	TEST_EQUAL("3", "3.5", 0);
 	TEST_EQUAL("\"abc\"", "\"abc\"", 1);
 	TEST_EQUAL("\"abc\"", "\"abcd\"", 0);
 	TEST_EQUAL("[]", "[]", 1);
@@ -545,6 +1302,473 @@ static void test_swap() {
 	lept_free(&v2);
 }
 
+//ĵɽ
+#define EXPECT_DOCUMENT(expect, doc)\
+    do {\
+        size_t length;\
+        char* json2 = lept_stringify(lept_document_root(doc), &length);\
+        EXPECT_EQ_STRING(expect, json2, length);\
+        free(json2);\
+    } while(0)
+
+//ĵ  arena  ޸ĺȻͷ(ûй©Ҳûظͷ)
+static void test_document() {
+	static const char json[] = "{\"n\":null,\"s\":\"abc\",\"a\":[1,\"x\",[2]],\"o\":{\"k\":\"v\"}}";
+	lept_document* doc = lept_document_create();
+	lept_value *root, *a, *o, copy;
+	char* big;
+	size_t i;
+
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(lept_document_root(doc)));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(doc, json));
+	EXPECT_DOCUMENT(json, doc);
+
+	/* ½ͷԭ */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(doc, "[\"a\",{\"b\":[]}]"));
+	EXPECT_DOCUMENT("[\"a\",{\"b\":[]}]", doc);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_document_parse(doc, "[\"a\",{\"b\":[]}"));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(lept_document_root(doc)));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_document_parse_n(doc, "[1] x", 5));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(lept_document_root(doc)));
+
+	/* ޸ĵеֵ */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(doc, json));
+	root = lept_document_root(doc);
+	lept_set_string(lept_find_object_value(root, "s", 1), "changed", 7);
+	a = lept_find_object_value(root, "a", 1);
+	lept_set_string(lept_get_array_element(a, 0), "one", 3);
+	lept_set_number(lept_pushback_array_element(a), 4.0);
+	lept_set_string(lept_insert_array_element(a, 1), "ins", 3);
+	lept_erase_array_element(a, 2, 1);
+	lept_set_array(lept_get_array_element(lept_get_array_element(a, 2), 0), 0);
+	o = lept_find_object_value(root, "o", 1);
+	lept_set_string(lept_set_object_value(o, "k2", 2), "v2", 2);
+	lept_shrink_array(a);
+	EXPECT_DOCUMENT("{\"n\":null,\"s\":\"changed\",\"a\":[\"one\",\"ins\",[[]],4],\"o\":{\"k\":\"v\",\"k2\":\"v2\"}}", doc);
+	lept_remove_object_value(root, 0);
+	a = lept_find_object_value(root, "a", 1);
+
+	/* Ƶĵֵĵ޹ */
+	lept_init(&copy);
+	lept_copy(&copy, a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(doc, "\"new\""));
+	EXPECT_EQ_SIZE_T(4, lept_get_array_size(&copy));
+	EXPECT_EQ_STRING("one", lept_get_string(lept_get_array_element(&copy, 0)), 3);
+	lept_free(&copy);
+
+	/* һarenaСĵ */
+	big = (char*)malloc(300004);
+	big[0] = '[';
+	for (i = 1; i < 300001; i += 3)
+		memcpy(big + i, "[],", 3);
+	memcpy(big + 300001, "1]", 3);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(doc, big));
+	EXPECT_EQ_SIZE_T(100001, lept_get_array_size(lept_document_root(doc)));
+	free(big);
+
+	lept_document_destroy(doc);
+}
+
+//ԿظʹõĽ  νĽ lept_parse() ͬ
+static void test_parser() {
+	static const char* jsons[] = {
+		"[1,\"a\",{\"b\":[true,false,null]}]", "\"abc\\u0000\"", "{\"k\":[[[[[]]]]]}", "[1,2", "[1] x", "-0.5"
+	};
+	lept_parser* p = lept_parser_create();
+	lept_value v1, v2;
+	char* big;
+	size_t i, round;
+
+	for (round = 0; round < 3; round++) {
+		for (i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++) {
+			lept_init(&v1);
+			lept_init(&v2);
+			EXPECT_EQ_INT(lept_parse(&v1, jsons[i]), lept_parser_parse(p, &v2, jsons[i], strlen(jsons[i])));
+			EXPECT_TRUE(lept_is_equal(&v1, &v2));
+			lept_free(&v1);
+			lept_free(&v2);
+		}
+		/* ڶÿνͷջ  ֶͷջ */
+		lept_parser_set_trim_size(p, 0);
+		if (round == 1)
+			lept_parser_reset(p);
+	}
+
+	/* ջҪչܴĽ  ֮С trim_size */
+	lept_parser_set_trim_size(p, 1024);
+	big = (char*)malloc(20001);
+	memset(big, '[', 10000);
+	memset(big + 10000, ']', 10000);
+	big[20000] = '\0';
+	lept_init(&v1);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v1, big, 20000));
+	EXPECT_EQ_SIZE_T(1, lept_get_array_size(&v1));
+	lept_free(&v1);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v1, "[\"after trim\"]", 14));
+	EXPECT_EQ_STRING("after trim", lept_get_string(lept_get_array_element(&v1, 0)), 10);
+	lept_free(&v1);
+	free(big);
+
+	lept_parser_destroy(p);
+}
+
+//Լȥ   lept_parse() ͬ  õļ޸  ƺͷ֮ȻЧ
+static void test_parser_intern() {
+	static const char json[] = "[{\"id\":1,\"name\":\"a\",\"tags\":{\"x\":1}},{\"name\":\"b\",\"id\":2,\"tags\":{\"x\":2,\"id\":3}}]";
+	lept_parser* p = lept_parser_create();
+	lept_value v1, v2, v3;
+	lept_value *a, *b;
+	char* big;
+	size_t i, length;
+
+	lept_parser_set_intern_keys(p, 1);
+	lept_init(&v1);
+	lept_init(&v2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v1, json));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v2, json, strlen(json)));
+	EXPECT_TRUE(lept_is_equal(&v1, &v2));
+	lept_free(&v1);
+	a = lept_get_array_element(&v2, 0);
+	b = lept_get_array_element(&v2, 1);
+	EXPECT_TRUE(lept_get_object_key(a, 0) == lept_get_object_key(b, 1));
+	EXPECT_TRUE(lept_get_object_key(a, 1) == lept_get_object_key(b, 0));
+	EXPECT_TRUE(lept_get_object_key(a, 0) == lept_get_object_key(lept_find_object_value(b, "tags", 4), 1));
+
+	/* һνȻͬļ */
+	lept_init(&v3);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v3, "{\"name\":0,\"new\":1}", 18));
+	EXPECT_TRUE(lept_get_object_key(&v3, 0) == lept_get_object_key(a, 1));
+	lept_free(&v3);
+
+	/* ÿνͷջ  ȥرӰ */
+	lept_parser_set_trim_size(p, 0);
+	for (i = 0; i < 2; i++) {
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v3, "{\"id\":0}", 8));
+		EXPECT_TRUE(lept_get_object_key(&v3, 0) == lept_get_object_key(a, 0));
+		lept_free(&v3);
+	}
+
+	/* ޸    ɾ */
+	lept_set_number(lept_set_object_value(a, "added", 5), 4.0);
+	lept_remove_object_value(b, 0);
+	lept_copy(&v3, &v2);
+	EXPECT_TRUE(lept_is_equal(&v3, &v2));
+	EXPECT_TRUE(lept_get_object_key(lept_get_array_element(&v3, 1), 0) == lept_get_object_key(a, 0));
+	lept_free(&v2);
+	lept_parser_reset(p);
+	lept_clear_object(lept_get_array_element(&v3, 0));
+	EXPECT_EQ_STRING("id", lept_get_object_key(lept_get_array_element(&v3, 1), 0), 2);
+	lept_free(&v3);
+
+	/* ʧʱͷѾļ */
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parser_parse(p, &v2, "[{\"id\":1},{\"id\":2 \"name\"}]", 26));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parser_parse(p, &v2, "{\"id\":{\"id\":x}}", 15));
+
+	/* ͬļ LEPT_INTERN_MAX_KEYS ֮ٹ   */
+	lept_init(&v1);
+	lept_set_object(&v1, 0);
+	for (i = 0; i < 5000; i++) {
+		char key[16];
+		sprintf(key, "k%lu", (unsigned long)i);
+		lept_set_number(lept_set_object_value(&v1, key, strlen(key)), (double)i);
+	}
+	big = lept_stringify(&v1, &length);
+	for (i = 0; i < 2; i++) {
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v2, big, length));
+		EXPECT_TRUE(lept_is_equal(&v1, &v2));
+		EXPECT_TRUE(lept_find_object_value(&v2, "k4999", 5) != NULL);
+		lept_free(&v2);
+	}
+	free(big);
+	lept_free(&v1);
+
+	lept_parser_set_intern_keys(p, 0);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v2, json, strlen(json)));
+	EXPECT_TRUE(lept_get_object_key(lept_get_array_element(&v2, 0), 0) != lept_get_object_key(lept_get_array_element(&v2, 1), 1));
+	lept_free(&v2);
+	lept_parser_destroy(p);
+}
+
+#define TEST_UTF8(expect, json)\
+    do {\
+        lept_value v;\
+        lept_init(&v);\
+        EXPECT_EQ_INT(expect, lept_parser_parse(p, &v, json, sizeof(json) - 1));\
+        lept_free(&v);\
+    } while(0)
+
+static void test_parser_validate_utf8() {
+	static const char* const invalid[] = {
+		"\x80", "\xBF", "\xC0\x80", "\xC1\xBF", "\xC2", "\xC2\x41", "\xE0\x80\x80", "\xE0\x9F\xBF",
+		"\xE4\xB8", "\xED\xA0\x80", "\xED\xBF\xBF", "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF", "\xF0\x9F\x98",
+		"\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xF8\x88\x80\x80\x80", "\xFE", "\xFF", "\xC2\x80\x80"
+	};
+	lept_parser* p = lept_parser_create();
+	lept_value v;
+	char json[128];
+	size_t i, j, n;
+
+	/* ĬϲУ */
+	TEST_UTF8(LEPT_PARSE_OK, "\"\xC0\x80\"");
+	TEST_UTF8(LEPT_PARSE_OK, "\"\\uDC00\"");
+
+	lept_parser_set_validate_utf8(p, 1);
+	TEST_UTF8(LEPT_PARSE_OK, "\"\"");
+	TEST_UTF8(LEPT_PARSE_OK, "\"\x7F\xC2\x80\xDF\xBF\xE0\xA0\x80\xE4\xB8\xAD\xED\x9F\xBF\xEE\x80\x80\xEF\xBF\xBF\"");
+	TEST_UTF8(LEPT_PARSE_OK, "\"\xF0\x90\x80\x80\xF0\x9F\x98\x80\xF3\xBF\xBF\xBF\xF4\x8F\xBF\xBF\"");
+	TEST_UTF8(LEPT_PARSE_OK, "{\"\xE9\x94\xAE\":[\"\xC3\xA9\\n\xC3\xA9\",\"\\uD834\\uDD1E\"]}");
+	TEST_UTF8(LEPT_PARSE_INVALID_UTF8, "\"\xC3\"");
+	TEST_UTF8(LEPT_PARSE_INVALID_UTF8, "\"\xC3\\n\xA9\"");
+	TEST_UTF8(LEPT_PARSE_INVALID_UTF8, "{\"\xFF\":1}");
+	TEST_UTF8(LEPT_PARSE_INVALID_UTF8, "[1,{\"a\":[\"ok\",\"\xED\xB0\x80\"]}]");
+	TEST_UTF8(LEPT_PARSE_INVALID_UNICODE_SURROGATE, "\"\\uDC00\"");
+	TEST_UTF8(LEPT_PARSE_INVALID_UNICODE_SURROGATE, "\"\\uDFFF\"");
+
+	/* ڳַĲͬλ  SIMDÿμ16/32ֽڵı߽ */
+	for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		n = strlen(invalid[i]);
+		for (j = 0; j < 70; j++) {
+			memset(json, 'a', sizeof(json));
+			json[0] = '"';
+			memcpy(json + 1 + j, invalid[i], n);
+			json[j + n + 1 + j % 3] = '"';
+			lept_init(&v);
+			EXPECT_EQ_INT(LEPT_PARSE_INVALID_UTF8, lept_parser_parse(p, &v, json, j + n + 2 + j % 3));
+			lept_free(&v);
+			/* ͬλõĺϷַ */
+			memcpy(json + 1 + j, "\xF0\x9F\x98\x80", 4);
+			json[j + 5] = '"';
+			lept_init(&v);
+			EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v, json, j + 6));
+			EXPECT_EQ_SIZE_T(j + 4, lept_get_string_length(&v));
+			lept_free(&v);
+		}
+	}
+	lept_parser_destroy(p);
+}
+
+#define TEST_CBOR_ENCODE(json, cbor)\
+    do {\
+        lept_value v;\
+        char* data;\
+        size_t length;\
+        lept_init(&v);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));\
+        data = lept_encode_cbor(&v, &length);\
+        EXPECT_EQ_SIZE_T(sizeof(cbor) - 1, length);\
+        EXPECT_TRUE(memcmp(cbor, data, length) == 0);\
+        free(data);\
+        lept_free(&v);\
+    } while(0)
+
+#define TEST_CBOR_DECODE(json, cbor)\
+    do {\
+        lept_value v, v2;\
+        lept_init(&v2);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v, cbor, sizeof(cbor) - 1));\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v2, json));\
+        EXPECT_TRUE(lept_is_equal(&v, &v2));\
+        lept_free(&v);\
+        lept_free(&v2);\
+    } while(0)
+
+/* ظʱ lept_is_equal() Ƚ  ɵıȽ */
+#define TEST_CBOR_DECODE_TEXT(json, cbor)\
+    do {\
+        lept_value v;\
+        char* json2;\
+        size_t length2;\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v, cbor, sizeof(cbor) - 1));\
+        json2 = lept_stringify(&v, &length2);\
+        EXPECT_EQ_STRING(json, json2, length2);\
+        free(json2);\
+        lept_free(&v);\
+    } while(0)
+
+#define TEST_CBOR_ERROR(error, cbor)\
+    do {\
+        lept_value v;\
+        lept_init(&v);\
+        lept_set_boolean(&v, 0);\
+        EXPECT_EQ_INT(error, lept_decode_cbor(&v, cbor, sizeof(cbor) - 1));\
+        EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));\
+        lept_free(&v);\
+    } while(0)
+
+#define TEST_CBOR_ROUNDTRIP(json)\
+    do {\
+        lept_value v, v2;\
+        char *data, *json2;\
+        size_t length, length2;\
+        lept_init(&v);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));\
+        data = lept_encode_cbor(&v, &length);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v2, data, length));\
+        EXPECT_TRUE(lept_is_equal(&v, &v2));\
+        json2 = lept_stringify(&v2, &length2);\
+        EXPECT_EQ_STRING(json, json2, length2);\
+        free(json2);\
+        free(data);\
+        lept_free(&v);\
+        lept_free(&v2);\
+    } while(0)
+
+//CBOR  RFC 8949 ¼A
+static void test_cbor() {
+	lept_value v;
+	char *data, *json2, json[512];
+	const char* text;
+	size_t i, length;
+
+	TEST_CBOR_ENCODE("0", "\x00");
+	TEST_CBOR_ENCODE("23", "\x17");
+	TEST_CBOR_ENCODE("24", "\x18\x18");
+	TEST_CBOR_ENCODE("1000", "\x19\x03\xe8");
+	TEST_CBOR_ENCODE("1000000", "\x1a\x00\x0f\x42\x40");
+	TEST_CBOR_ENCODE("1000000000000", "\x1b\x00\x00\x00\xe8\xd4\xa5\x10\x00");
+	TEST_CBOR_ENCODE("18446744073709551615", "\x1b\xff\xff\xff\xff\xff\xff\xff\xff");
+	TEST_CBOR_ENCODE("-1", "\x20");
+	TEST_CBOR_ENCODE("-1000", "\x39\x03\xe7");
+	TEST_CBOR_ENCODE("-9223372036854775808", "\x3b\x7f\xff\xff\xff\xff\xff\xff\xff");
+	TEST_CBOR_ENCODE("-0", "\xf9\x80\x00");
+	TEST_CBOR_ENCODE("1.5", "\xf9\x3e\x00");
+	TEST_CBOR_ENCODE("65504.0", "\xf9\x7b\xff");
+	TEST_CBOR_ENCODE("5.960464477539063e-8", "\xf9\x00\x01");
+	TEST_CBOR_ENCODE("0.00006103515625", "\xf9\x04\x00");
+	TEST_CBOR_ENCODE("-4.0", "\xf9\xc4\x00");
+	TEST_CBOR_ENCODE("100000.0", "\xfa\x47\xc3\x50\x00");
+	TEST_CBOR_ENCODE("3.4028234663852886e+38", "\xfa\x7f\x7f\xff\xff");
+	TEST_CBOR_ENCODE("1.1", "\xfb\x3f\xf1\x99\x99\x99\x99\x99\x9a");
+	TEST_CBOR_ENCODE("1.0e+300", "\xfb\x7e\x37\xe4\x3c\x88\x00\x75\x9c");
+	TEST_CBOR_ENCODE("false", "\xf4");
+	TEST_CBOR_ENCODE("true", "\xf5");
+	TEST_CBOR_ENCODE("null", "\xf6");
+	TEST_CBOR_ENCODE("\"\"", "\x60");
+	TEST_CBOR_ENCODE("\"IETF\"", "\x64\x49\x45\x54\x46");
+	TEST_CBOR_ENCODE("\"\\u00fc\"", "\x62\xc3\xbc");
+	TEST_CBOR_ENCODE("[]", "\x80");
+	TEST_CBOR_ENCODE("[1,[2,3],[4,5]]", "\x83\x01\x82\x02\x03\x82\x04\x05");
+	TEST_CBOR_ENCODE("{}", "\xa0");
+	TEST_CBOR_ENCODE("{\"a\":1,\"b\":[2,3]}", "\xa2\x61\x61\x01\x61\x62\x82\x02\x03");
+
+	TEST_CBOR_DECODE("0", "\x1b\x00\x00\x00\x00\x00\x00\x00\x00");
+	TEST_CBOR_DECODE("-1", "\x38\x00");
+	TEST_CBOR_DECODE("1.5", "\xfb\x3f\xf8\x00\x00\x00\x00\x00\x00");
+	TEST_CBOR_DECODE("1e+300", "\xfb\x7e\x37\xe4\x3c\x88\x00\x75\x9c");
+	TEST_CBOR_DECODE("-18446744073709551616", "\x3b\xff\xff\xff\xff\xff\xff\xff\xff");
+	TEST_CBOR_DECODE("null", "\xf7");
+	TEST_CBOR_DECODE("\"\\u0001\"", "\xc1\x41\x01");
+	TEST_CBOR_DECODE("1363896240", "\xc1\x1a\x51\x4b\x67\xb0");
+	TEST_CBOR_DECODE("[]", "\x9f\xff");
+	TEST_CBOR_DECODE("[1,[2,3],[4,5]]", "\x9f\x01\x82\x02\x03\x9f\x04\x05\xff\xff");
+	TEST_CBOR_DECODE("{\"a\":1,\"b\":[2,3]}", "\xbf\x61\x61\x01\x61\x62\x9f\x02\x03\xff\xff");
+	TEST_CBOR_DECODE("\"streaming\"", "\x7f\x65\x73\x74\x72\x65\x61\x64\x6d\x69\x6e\x67\xff");
+	TEST_CBOR_DECODE("\"\"", "\x5f\xff");
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v, "\x1b\x7f\xff\xff\xff\xff\xff\xff\xff", 9));
+	EXPECT_EQ_INT(LEPT_NUMBER_INT64, lept_get_number_type(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v, "\x1b\x80\x00\x00\x00\x00\x00\x00\x00", 9));
+	EXPECT_EQ_INT(LEPT_NUMBER_UINT64, lept_get_number_type(&v));
+	lept_free(&v);
+
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x18");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\xfb\x3f\xf1");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x64\x49\x45");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x83\x01\x02");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\xa1\x61\x61");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x9f\x01");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x7f\x61\x61");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x9b\xff\xff\xff\xff\xff\xff\xff\xff");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\xbb\x00\x00\x00\x01\x00\x00\x00\x00\x01");
+	TEST_CBOR_ERROR(LEPT_PARSE_EXPECT_VALUE, "\x5b\xff\xff\xff\xff\xff\xff\xff\xff");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\x1c");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\x1f");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xff");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xf0");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xf8\x20");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\x82\x01\xff");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\x7f\x01\xff");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\x7f\x7f\xff\xff");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xbf\x61\x61\xff");
+	/* JSON ܱʾNaN */
+	TEST_CBOR_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "\xf9\x7c\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "\xf9\xfc\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "\xfa\x7f\x80\x00\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "\xfb\xff\xf0\x00\x00\x00\x00\x00\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xf9\x7e\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xfa\x7f\xc0\x00\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\xfb\x7f\xf8\x00\x00\x00\x00\x00\x00");
+	TEST_CBOR_ERROR(LEPT_PARSE_INVALID_VALUE, "\x82\x01\xf9\x7e\x00");
+	/* ظļ lept_parse() һ  ԭ˳ */
+	TEST_CBOR_DECODE_TEXT("{\"a\":1,\"a\":2}", "\xa2\x61\x61\x01\x61\x61\x02");
+	TEST_CBOR_DECODE_TEXT("{\"a\":1,\"b\":2,\"a\":3}", "\xbf\x61\x61\x01\x61\x62\x02\x61\x61\x03\xff");
+	TEST_CBOR_DECODE_TEXT("{\"a\":1,\"a\":2}", "\xa2\x7f\x61\x61\xff\x01\x61\x61\x02");
+	TEST_CBOR_DECODE("{\"a\":{\"a\":1},\"b\":{\"a\":2}}", "\xa2\x61\x61\xa1\x61\x61\x01\x61\x62\xa1\x61\x61\x02");
+	TEST_CBOR_ERROR(LEPT_PARSE_MISS_KEY, "\xa1\x01\x02");
+	TEST_CBOR_ERROR(LEPT_PARSE_MISS_KEY, "\xa1\x80\x02");
+	TEST_CBOR_ERROR(LEPT_PARSE_ROOT_NOT_SINGULAR, "\x01\x02");
+	TEST_CBOR_ERROR(LEPT_PARSE_ROOT_NOT_SINGULAR, "\x80\xff");
+
+	/* Ƕײ */
+	data = (char*)malloc(2000);
+	memset(data, 0x81, 2000);
+	data[1999] = 0;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_decode_cbor(&v, data, 2000));
+	for (i = 0; i < 2000; i++)
+		data[i] = (char)0x9f;
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_decode_cbor(&v, data, 2000));
+	memset(data, 0x81, 100);
+	data[99] = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v, data, 100));
+	lept_free(&v);
+	free(data);
+
+	TEST_CBOR_ROUNDTRIP("null");
+	TEST_CBOR_ROUNDTRIP("-0");
+	TEST_CBOR_ROUNDTRIP("1.5");
+	TEST_CBOR_ROUNDTRIP("3.25");
+	TEST_CBOR_ROUNDTRIP("-1e-310");
+	TEST_CBOR_ROUNDTRIP("1.2345678901234567");
+	TEST_CBOR_ROUNDTRIP("9223372036854775807");
+	TEST_CBOR_ROUNDTRIP("-9223372036854775808");
+	TEST_CBOR_ROUNDTRIP("18446744073709551615");
+	TEST_CBOR_ROUNDTRIP("\"Hello\\u0000World\"");
+	TEST_CBOR_ROUNDTRIP("\"\\\"\\\\/\\b\\f\\n\\r\\t\"");
+	TEST_CBOR_ROUNDTRIP("\"a string longer than the short string buffer\"");
+	TEST_CBOR_ROUNDTRIP("[null,false,true,123,\"abc\",[1,2,3]]");
+	TEST_CBOR_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
+
+	/* lept_parse() ظ  ٽ֮ı(ԱĶ) */
+	strcpy(json, "{");
+	for (i = 0; i < 20; i++)
+		sprintf(json + strlen(json), "\"k%lu\":%lu,", (unsigned long)i, (unsigned long)i);
+	strcat(json, "\"k3\":[{\"a\":1,\"a\":2}]}");
+	for (i = 0; i < 2; i++) {
+		text = i == 0 ? "{\"a\":1,\"a\":2}" : json;
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, text));
+		data = lept_encode_cbor(&v, &length);
+		lept_free(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_decode_cbor(&v, data, length));
+		json2 = lept_stringify(&v, &length);
+		EXPECT_TRUE(length == strlen(text) && strcmp(text, json2) == 0);
+		free(json2);
+		free(data);
+		lept_free(&v);
+	}
+
+	lept_init(&v);
+	lept_set_string(&v, "x", 1);
+	data = lept_encode_cbor(&v, NULL);
+	EXPECT_TRUE(memcmp("\x61x", data, 2) == 0);
+	free(data);
+	lept_free(&v);
+}
+
 //дnull
 static void test_access_null() {
 	lept_value v;
@@ -587,6 +1811,31 @@ static void test_access_number() {
 
 	lept_set_number(&v, 1234.5);
 	EXPECT_EQ_DOUBLE(1234.5, lept_get_number(&v));
+	EXPECT_EQ_INT(LEPT_NUMBER_DOUBLE, lept_get_number_type(&v));
+	EXPECT_TRUE(lept_get_int64(&v) == 1234);
+
+	lept_free(&v);
+}
+
+//д64λ
+static void test_access_int64() {
+	lept_value v;
+	lept_init(&v);
+	lept_set_string(&v, "a", 1);
+
+	lept_set_int64(&v, -(lept_int64)U64(0x200000, 1));
+	EXPECT_EQ_INT(LEPT_NUMBER, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_NUMBER_INT64, lept_get_number_type(&v));
+	EXPECT_TRUE(lept_get_int64(&v) == -(lept_int64)U64(0x200000, 1));
+	EXPECT_EQ_DOUBLE(-9007199254740992.0, lept_get_number(&v));
+
+	lept_set_uint64(&v, U64(0xFFFFFFFF, 0xFFFFFFFF));
+	EXPECT_EQ_INT(LEPT_NUMBER_UINT64, lept_get_number_type(&v));
+	EXPECT_TRUE(lept_get_uint64(&v) == U64(0xFFFFFFFF, 0xFFFFFFFF));
+
+	//дdouble֮
+	lept_set_number(&v, 0.5);
+	EXPECT_EQ_INT(LEPT_NUMBER_DOUBLE, lept_get_number_type(&v));
 
 	lept_free(&v);
 }
@@ -599,12 +1848,61 @@ static void test_access_string() {
 
 	EXPECT_EQ_STRING("", lept_get_string(&v), lept_get_string_length(&v));
 
-	lept_set_string(&v, "Hello", 5);
+	EXPECT_EQ_INT(0, lept_set_string(&v, "Hello", 5));
 	EXPECT_EQ_STRING("Hello", lept_get_string(&v), lept_get_string_length(&v));
 
+#ifdef LEPT_COMPACT_VALUE
+	/* ղֵĽ16ֽ  ȳ UINT_MAX ʱʧ  v (ֻ鳤   s) */
+	EXPECT_EQ_SIZE_T(16, sizeof(lept_value));
+	if ((size_t)-1 > UINT_MAX) {
+		EXPECT_EQ_INT(-1, lept_set_string(&v, "Hello", (size_t)UINT_MAX + 1));
+		EXPECT_EQ_STRING("Hello", lept_get_string(&v), lept_get_string_length(&v));
+	}
+#endif
+
 	lept_free(&v);
 }
 
+//ַڽ  ڱ߽ʱ        ƶ  Ľͬ
+static void test_access_short_string() {
+	static const char chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+	lept_value v, v2, v3;
+	char json[64];
+	size_t len;
+
+	for (len = 0; len < 32; len++) {
+		lept_init(&v);
+		lept_set_string(&v, chars, len);
+		EXPECT_EQ_SIZE_T(len, lept_get_string_length(&v));
+		EXPECT_TRUE(memcmp(chars, lept_get_string(&v), len) == 0 && lept_get_string(&v)[len] == '\0');
+
+		sprintf(json, "[\"%.*s\"]", (int)len, chars);
+		lept_init(&v2);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v2, json));
+		EXPECT_TRUE(lept_is_equal(&v, lept_get_array_element(&v2, 0)));
+
+		lept_init(&v3);
+		lept_copy(&v3, &v);
+		EXPECT_TRUE(lept_is_equal(&v, &v3));
+		lept_move(&v3, lept_get_array_element(&v2, 0));
+		EXPECT_EQ_SIZE_T(len, lept_get_string_length(&v3));
+		EXPECT_TRUE(memcmp(chars, lept_get_string(&v3), len) == 0);
+		lept_set_string(&v2, "x", 1);
+		lept_swap(&v2, &v3);
+		EXPECT_TRUE(lept_is_equal(&v, &v2));
+		EXPECT_EQ_STRING("x", lept_get_string(&v3), lept_get_string_length(&v3));
+
+		/* Լ */
+		lept_set_string(&v, lept_get_string(&v) + 1, len > 0 ? len - 1 : 0);
+		EXPECT_EQ_SIZE_T(len > 0 ? len - 1 : 0, lept_get_string_length(&v));
+		EXPECT_TRUE(memcmp(chars + 1, lept_get_string(&v), lept_get_string_length(&v)) == 0);
+
+		lept_free(&v);
+		lept_free(&v2);
+		lept_free(&v3);
+	}
+}
+
 //
 static void test_access_array() {
 	lept_value a, e;
@@ -756,13 +2054,355 @@ static void test_access_object() {
 
 }
 
+//ԱֵĶ  ߹ϣ  ɾ֮ҽҪͳԱһ
+static void expect_object_keys(lept_value* o, size_t first, size_t last) {
+	char key[16];
+	size_t i, index;
+	EXPECT_EQ_SIZE_T(last - first, lept_get_object_size(o));
+	for (i = 0; i < 400; i++) {
+		sprintf(key, "k%lu", (unsigned long)i);
+		index = lept_find_object_index(o, key, strlen(key));
+		if (i >= first && i < last) {
+			EXPECT_TRUE(index != LEPT_KEY_NOT_EXIST);
+			if (index != LEPT_KEY_NOT_EXIST)
+				EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_object_value(o, index)));
+		}
+		else
+			EXPECT_TRUE(index == LEPT_KEY_NOT_EXIST);
+	}
+}
+
+static void test_access_object_index() {
+	lept_value o, o2;
+	lept_document* doc;
+	char key[16];
+	char* json;
+	size_t i, length;
+
+	lept_init(&o);
+	lept_set_object(&o, 0);
+	for (i = 0; i < 300; i++) {
+		sprintf(key, "k%lu", (unsigned long)i);
+		lept_set_number(lept_set_object_value(&o, key, strlen(key)), (double)i);
+	}
+	expect_object_keys(&o, 0, 300);
+	/* Ѿڵļظ */
+	lept_set_number(lept_set_object_value(&o, "k7", 2), 7.0);
+	expect_object_keys(&o, 0, 300);
+
+	/* ɾǰĳԱ  Ա±ı */
+	for (i = 0; i < 100; i++)
+		lept_remove_object_value(&o, 0);
+	expect_object_keys(&o, 100, 300);
+	lept_shrink_object(&o);
+	EXPECT_EQ_SIZE_T(200, lept_get_object_capacity(&o));
+	expect_object_keys(&o, 100, 300);
+
+	/* õĶ  ˳ͬҲ */
+	json = lept_stringify(&o, &length);
+	lept_init(&o2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&o2, json));
+	expect_object_keys(&o2, 100, 300);
+	lept_remove_object_value(&o2, lept_find_object_index(&o2, "k100", 4));
+	lept_set_number(lept_set_object_value(&o2, "k100", 4), 100.0);
+	EXPECT_TRUE(lept_is_equal(&o, &o2));
+	lept_free(&o2);
+
+	/* arenaеĶ  µļʱƵ */
+	doc = lept_document_create();
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(doc, json));
+	expect_object_keys(lept_document_root(doc), 100, 300);
+	lept_remove_object_value(lept_document_root(doc), lept_find_object_index(lept_document_root(doc), "k299", 4));
+	expect_object_keys(lept_document_root(doc), 100, 299);
+	for (i = 300; i < 400; i++) {
+		sprintf(key, "k%lu", (unsigned long)i);
+		lept_set_number(lept_set_object_value(lept_document_root(doc), key, strlen(key)), (double)i);
+	}
+	lept_set_number(lept_set_object_value(lept_document_root(doc), "k299", 4), 299.0);
+	expect_object_keys(lept_document_root(doc), 100, 400);
+	lept_document_destroy(doc);
+	free(json);
+
+	/* ֮¼ */
+	lept_clear_object(&o);
+	expect_object_keys(&o, 0, 0);
+	for (i = 0; i < 50; i++) {
+		sprintf(key, "k%lu", (unsigned long)i);
+		lept_set_number(lept_set_object_value(&o, key, strlen(key)), (double)i);
+	}
+	expect_object_keys(&o, 0, 50);
+	lept_free(&o);
+}
+
+//ƽĵ±ΪiĽ v ͬ  ͬʱ lept_tape_next() 
+static int tape_equal(const lept_tape* t, size_t i, const lept_value* v, size_t* next) {
+	size_t n, k, e;
+	if (lept_tape_get_type(t, i) != lept_get_type(v))
+		return 0;
+	switch (lept_get_type(v)) {
+	case LEPT_NUMBER:
+		if (lept_tape_get_number_type(t, i) != lept_get_number_type(v) || lept_tape_get_uint64(t, i) != lept_get_uint64(v)
+			|| lept_tape_get_int64(t, i) != lept_get_int64(v) || lept_tape_get_number(t, i) != lept_get_number(v))
+			return 0;
+		break;
+	case LEPT_STRING:
+		if (lept_tape_get_string_length(t, i) != lept_get_string_length(v)
+			|| memcmp(lept_tape_get_string(t, i), lept_get_string(v), lept_get_string_length(v) + 1) != 0)
+			return 0;
+		break;
+	case LEPT_ARRAY:
+		if ((n = lept_tape_get_array_size(t, i)) != lept_get_array_size(v))
+			return 0;
+		for (k = 0, e = n ? lept_tape_get_array_element(t, i, 0) : 0; k < n; k++)
+			if (lept_tape_get_array_element(t, i, k) != e || !tape_equal(t, e, lept_get_array_element((lept_value*)v, k), &e))
+				return 0;
+		break;
+	case LEPT_OBJECT:
+		if ((n = lept_tape_get_object_size(t, i)) != lept_get_object_size(v))
+			return 0;
+		for (k = 0; k < n; k++) {
+			if (lept_tape_get_object_key_length(t, i, k) != lept_get_object_key_length(v, k)
+				|| memcmp(lept_tape_get_object_key(t, i, k), lept_get_object_key(v, k), lept_get_object_key_length(v, k)) != 0
+				|| !tape_equal(t, lept_tape_get_object_value(t, i, k), lept_get_object_value((lept_value*)v, k), &e))
+				return 0;
+		}
+		break;
+	default:
+		break;
+	}
+	*next = lept_tape_next(t, i);
+	return 1;
+}
+
+static void test_access_tape() {
+	static const char* samples[] = {
+		"null", "false", "true", "-0.0", "123", "-9223372036854775808", "18446744073709551615", "1.5e300", "\"\"",
+		"\"Hello\\u0000World\"", "[ ]", "{ }", "[ null , false , true , 123 , \"abc\", [[]], {} ]",
+		" { \"n\" : null , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", \"a\" : [ 1, 2, 3 ], \"o\" : { \"1\" : 1, \"2\" : 2 }, \"\" : [{\"x\":[]}] } "
+	};
+	lept_tape* t = lept_tape_create();
+	lept_value v;
+	size_t i, next;
+
+	EXPECT_EQ_INT(LEPT_NULL, lept_tape_get_type(t, lept_tape_root(t)));
+	for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, samples[i]));
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_tape_parse(t, samples[i], strlen(samples[i])));
+		EXPECT_TRUE(tape_equal(t, lept_tape_root(t), &v, &next));
+		lept_free(&v);
+	}
+
+	/*   Ҳʱ LEPT_KEY_NOT_EXIST */
+	i = lept_tape_find_object_value(t, lept_tape_root(t), "o", 1);
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_tape_get_type(t, i));
+	EXPECT_EQ_DOUBLE(2.0, lept_tape_get_number(t, lept_tape_find_object_value(t, i, "2", 1)));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_tape_find_object_value(t, i, "3", 1));
+	i = lept_tape_find_object_value(t, lept_tape_root(t), "", 0);
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_tape_get_type(t, i));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_tape_find_object_value(t, lept_tape_root(t), "x", 1));
+	EXPECT_TRUE(lept_tape_get_boolean(t, lept_tape_find_object_value(t, lept_tape_root(t), "t", 1)));
+
+	/*  lept_parse() ͬ  ʧʱΪnull */
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_tape_parse(t, "[1, \"a\" {", 9));
+	EXPECT_EQ_INT(LEPT_NULL, lept_tape_get_type(t, lept_tape_root(t)));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_tape_parse(t, "{} x", 4));
+	EXPECT_EQ_INT(LEPT_NULL, lept_tape_get_type(t, lept_tape_root(t)));
+	lept_tape_destroy(t);
+}
+
+//Ľ v ͬ   Ȱ±һԪ/Ա  ֻչһܼ֮չ
+static int lazy_equal(lept_lazy_value* l, const lept_value* v) {
+	size_t n, k;
+	if (lept_lazy_get_type(l) != lept_get_type(v))
+		return 0;
+	switch (lept_get_type(v)) {
+	case LEPT_ARRAY:
+		if ((n = lept_get_array_size(v)) > 0 && !lazy_equal(lept_lazy_get_array_element(l, n - 1), lept_get_array_element((lept_value*)v, n - 1)))
+			return 0;
+		if (lept_lazy_get_array_size(l) != n)
+			return 0;
+		for (k = 0; k < n; k++)
+			if (!lazy_equal(lept_lazy_get_array_element(l, k), lept_get_array_element((lept_value*)v, k)))
+				return 0;
+		break;
+	case LEPT_OBJECT:
+		n = lept_get_object_size(v);
+		for (k = 0; k < n; k++) {
+			if (lept_lazy_find_object_value(l, lept_get_object_key(v, k), lept_get_object_key_length(v, k))
+				!= lept_lazy_get_object_value(l, lept_find_object_index(v, lept_get_object_key(v, k), lept_get_object_key_length(v, k)))
+				|| lept_lazy_get_object_key_length(l, k) != lept_get_object_key_length(v, k)
+				|| memcmp(lept_lazy_get_object_key(l, k), lept_get_object_key(v, k), lept_get_object_key_length(v, k) + 1) != 0
+				|| !lazy_equal(lept_lazy_get_object_value(l, k), lept_get_object_value((lept_value*)v, k)))
+				return 0;
+		}
+		if (lept_lazy_get_object_size(l) != n)
+			return 0;
+		break;
+	default:
+		break;
+	}
+	return lept_is_equal(lept_lazy_get_value(l), v);
+}
+
+static void test_access_lazy() {
+	static const char* samples[] = {
+		"null", " false ", "true", "-0.0", "123", "18446744073709551615", "1.5e300", "\"\"", "\"Hello\\u0000World\"",
+		"[ ]", "{ }", "[ null , false , true , 123 , \"a]b\\\"c\\\\\", [[]], {}, [ \"}\" ] ]",
+		" { \"n\" : null , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", \"a\" : [ 1, 2, 3 ], \"o\" : { \"1\" : 1, \"2\" : 2 }, \"\" : [{\"x\":[]}] } ",
+		"{\"a\\nb\":{\"c\\\\\":[\"\\\"{[\"]},\"\\u00e9\":\"x\"}"
+	};
+	lept_lazy* d = lept_lazy_create();
+	lept_lazy_value* l;
+	lept_value v;
+	size_t i;
+
+	EXPECT_TRUE(lept_lazy_root(d) == NULL);
+	for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, samples[i]));
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(d, samples[i], strlen(samples[i])));
+		EXPECT_TRUE(lazy_equal(lept_lazy_root(d), &v));
+		lept_free(&v);
+	}
+
+	/* ֻչҵĳԱ  ҲʱNULL */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(d, samples[13], strlen(samples[13])));
+	l = lept_lazy_find_object_value(lept_lazy_find_object_value(lept_lazy_root(d), "a\nb", 3), "c\\", 2);
+	EXPECT_EQ_STRING("\"{[", lept_get_string(lept_lazy_get_value(lept_lazy_get_array_element(l, 0))), 3);
+	EXPECT_TRUE(lept_lazy_find_object_value(lept_lazy_root(d), "none", 4) == NULL);
+	EXPECT_EQ_SIZE_T(2, lept_lazy_get_object_size(lept_lazy_root(d)));
+
+	/* ظļصһ */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(d, "{\"dup\":1,\"x\":0,\"dup\":2}", 23));
+	l = lept_lazy_find_object_value(lept_lazy_root(d), "dup", 3);
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_lazy_get_value(l)));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_lazy_get_value(lept_lazy_get_object_value(lept_lazy_root(d), 2))));
+
+	/*  lept_parse() ͬ  ʧʱûи */
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_lazy(d, "[1, \"a\" {", 9));
+	EXPECT_TRUE(lept_lazy_root(d) == NULL);
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_lazy(d, "{\"a\":[\"\\x\"]}", 12));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_lazy(d, "{} x", 4));
+	lept_lazy_destroy(d);
+}
+
+static lept_value* path_get(lept_value* v, const char* pointer) {
+	lept_path* p = lept_path_compile(pointer, strlen(pointer));
+	lept_value* r;
+	EXPECT_TRUE(p != NULL);
+	if (p == NULL)
+		return NULL;
+	r = lept_path_get(p, v);
+	lept_path_destroy(p);
+	return r;
+}
+
+static void test_access_path() {
+	/* RFC 6901 5ڵ */
+	static const char* keys[] = { "/", "/a~1b", "/c%d", "/e^f", "/g|h", "/i\\j", "/k\"l", "/ ", "/m~0n" };
+	static const char* paths[] = { "/id", "/tags/1", "/address/geo/0", "/address/geo/1" };
+	static const double values[] = { 1.0, 7.0, 1.5, 2.5 };
+	lept_value v, v2;
+	lept_path* p;
+	char json[512], json2[16];
+	size_t i, j;
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v,
+		"{\"foo\":[\"bar\",\"baz\"],\"\":0,\"a/b\":1,\"c%d\":2,\"e^f\":3,\"g|h\":4,\"i\\\\j\":5,\"k\\\"l\":6,\" \":7,\"m~n\":8}"));
+	EXPECT_TRUE(path_get(&v, "") == &v);
+	EXPECT_TRUE(path_get(&v, "/foo") == lept_find_object_value(&v, "foo", 3));
+	EXPECT_EQ_STRING("bar", lept_get_string(path_get(&v, "/foo/0")), lept_get_string_length(path_get(&v, "/foo/0")));
+	EXPECT_EQ_STRING("baz", lept_get_string(path_get(&v, "/foo/1")), lept_get_string_length(path_get(&v, "/foo/1")));
+	for (i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+		EXPECT_EQ_DOUBLE((double)i, lept_get_number(path_get(&v, keys[i])));
+
+	/* Ҳ */
+	EXPECT_TRUE(path_get(&v, "/foo/2") == NULL);
+	EXPECT_TRUE(path_get(&v, "/foo/-") == NULL);
+	EXPECT_TRUE(path_get(&v, "/foo/01") == NULL);
+	EXPECT_TRUE(path_get(&v, "/foo/+1") == NULL);
+	EXPECT_TRUE(path_get(&v, "/foo/") == NULL);
+	EXPECT_TRUE(path_get(&v, "/foo/99999999999999999999999999") == NULL);
+	EXPECT_TRUE(path_get(&v, "/foo/0/x") == NULL);
+	EXPECT_TRUE(path_get(&v, "/a/b") == NULL);
+	EXPECT_TRUE(path_get(&v, "/m~1n") == NULL);
+
+	/* Ϸָ */
+	EXPECT_TRUE(lept_path_compile("foo", 3) == NULL);
+	EXPECT_TRUE(lept_path_compile("/~2", 3) == NULL);
+	EXPECT_TRUE(lept_path_compile("/a~", 3) == NULL);
+	lept_free(&v);
+
+	/* ͬһ·ԳԱ˳ͬĵֵ  ڶĵĳԱֵ */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v,
+		"{\"id\":1,\"tags\":[6,7],\"address\":{\"city\":\"x\",\"geo\":[1.5,2.5]}}"));
+	strcpy(json, "{");
+	for (i = 0; i < 20; i++)
+		sprintf(json + strlen(json), "\"k%lu\":%lu,", (unsigned long)i, (unsigned long)i);
+	strcat(json, "\"address\":{\"geo\":[3.5,4.5],\"city\":\"y\"},\"tags\":[],\"id\":3}");
+	lept_init(&v2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v2, json));
+	for (j = 0; j < sizeof(paths) / sizeof(paths[0]); j++) {
+		p = lept_path_compile(paths[j], strlen(paths[j]));
+		EXPECT_EQ_DOUBLE(values[j], lept_get_number(lept_path_get(p, &v)));
+		if (j == 1)
+			EXPECT_TRUE(lept_path_get(p, &v2) == NULL);
+		else
+			EXPECT_EQ_DOUBLE(values[j] + 2.0, lept_get_number(lept_path_get(p, &v2)));
+		EXPECT_EQ_DOUBLE(values[j], lept_get_number(lept_path_get(p, &v)));
+		lept_path_destroy(p);
+	}
+	lept_free(&v);
+	lept_free(&v2);
+
+	/* ظļ   lept_find_object_index() һõһ  ֮ǰڱĵҵλòӰ */
+	p = lept_path_compile("/a", 2);
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "{\"x\":0,\"b\":1,\"a\":2}"));
+	lept_init(&v2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v2, "{\"y\":0,\"a\":3,\"a\":4}"));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_path_get(p, &v)));
+	EXPECT_EQ_DOUBLE(3.0, lept_get_number(lept_path_get(p, &v2)));
+	lept_free(&v);
+	lept_free(&v2);
+	strcpy(json, "{");
+	for (i = 0; i < 20; i++)
+		sprintf(json + strlen(json), "\"a%lu\":%lu,", (unsigned long)i, (unsigned long)i);
+	strcat(json, "\"a\":1,\"a\":2}");
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_TRUE(lept_path_get(p, &v) == lept_find_object_value(&v, "a", 1));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_path_get(p, &v)));
+	lept_path_destroy(p);
+	/* ĶñʱĹϣֵ */
+	for (i = 0; i < 20; i++) {
+		sprintf(json2, "/a%lu", (unsigned long)i);
+		p = lept_path_compile(json2, strlen(json2));
+		EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_path_get(p, &v)));
+		lept_path_destroy(p);
+	}
+	p = lept_path_compile("/a20", 4);
+	EXPECT_TRUE(lept_path_get(p, &v) == NULL);
+	lept_path_destroy(p);
+	lept_free(&v);
+}
+
 static void test_access() {
 	test_access_null();
 	test_access_boolean();
 	test_access_number();
+	test_access_int64();
 	test_access_string();
+	test_access_short_string();
 	test_access_array();
 	test_access_object();
+	test_access_object_index();
+	test_access_tape();
+	test_access_lazy();
+	test_access_path();
 }
 
 int main() {
@@ -775,6 +2415,11 @@ int main() {
 	test_copy();
 	test_move();
 	test_swap();
+	test_document();
+	test_parser();
+	test_parser_intern();
+	test_parser_validate_utf8();
+	test_cbor();
 	test_access();
 	printf("%d/%d (%3.2f%%) passed\n", test_pass, test_count, test_pass * 100.0 / test_count);
 	return main_ret;